@@ -32,7 +32,10 @@
 
 #include "Vectorf.h"
 #include "Intersectable.h"
+#include "Predicates.h"
+#include "ThreadPool.h"
 #include <set>
+#include <unordered_map>
 using namespace std;
 
 
@@ -74,6 +77,131 @@ struct ITri
   }
 } ;
 
+// A half-edge of the hull's face-adjacency mesh.  Face f owns half-edges
+// 3f, 3f+1, 3f+2 (wound ccw), so the face, next and prev of a half-edge are implicit:
+// face=e/3, next=Hull::nextHE(e).
+struct HalfEdge
+{
+  int vert ; // the vertex (index into verts) this half-edge leaves from
+  int twin ; // the oppositely wound half-edge in the neighbouring face. -1 if none.
+  
+  HalfEdge( int iVert ) : vert(iVert), twin(-1) {}
+} ;
+
+// A face slot in the hull's mesh.  Dead slots are recycled by addTri.
+struct HullFace
+{
+  bool alive ;
+  int visit ; // stamp of the last horizon search that found this face visible
+  int serial ; // when the face was made (Hull::faceSerial), tells a recycled slot from the old face
+  vector<int> outside ; // conflict list: verts more than `tolerance` outside this face
+  
+  HullFace() : alive(1), visit(-1), serial(0) {}
+} ;
+
+// A flat face of the finished hull: all the coplanar tris next to each other, merged.
+struct HullPolygon
+{
+  Plane plane ;
+  vector<int> pts ; // indices into finalPts (and transformedPts), ccw seen from the front of the plane
+  int normal ;      // index into finalNormals of this polygon's SAT axis
+  
+  HullPolygon() : normal(-1) {}
+} ;
+
+// A real edge of the finished hull, where 2 polygons meet (the diagonals inside a polygon aren't edges).
+struct HullEdge
+{
+  int a, b ;    // indices into finalPts, a->b runs ccw around poly[0]
+  int poly[2] ; // the polygon on each side, poly[1] is the one b->a runs ccw around
+  int dir ;     // index into finalEdgeDirs
+} ;
+
+// The simplex GJK builds on the Minkowski difference (me - o) of 2 hulls.
+// pts[n-1] is the newest vertex.
+struct GJKSimplex
+{
+  Vector3f pts[4] ;
+  int me[4], o[4] ; // the transformedPts on each hull that pts[i] is the difference of
+  int n ;
+  
+  GJKSimplex() : n(0) {}
+  
+  void push( const Vector3f& pt, int meIndex, int oIndex ) {
+    pts[n] = pt ;  me[n] = meIndex ;  o[n] = oIndex ;
+    n++ ;
+  }
+  
+  // Keep just the vertices listed (in that order, newest last)
+  void keep( int i ) {
+    GJKSimplex s = *this ;
+    n = 0 ;
+    push( s.pts[i], s.me[i], s.o[i] ) ;
+  }
+  void keep( int i, int j ) {
+    GJKSimplex s = *this ;
+    n = 0 ;
+    push( s.pts[i], s.me[i], s.o[i] ) ;  push( s.pts[j], s.me[j], s.o[j] ) ;
+  }
+  void keep( int i, int j, int k ) {
+    GJKSimplex s = *this ;
+    n = 0 ;
+    push( s.pts[i], s.me[i], s.o[i] ) ;  push( s.pts[j], s.me[j], s.o[j] ) ;  push( s.pts[k], s.me[k], s.o[k] ) ;
+  }
+} ;
+
+// Where a hull kept in local space is (see Hull::localSpace): pt p of it is at rot*p + pos.
+// moved is 0 for the identity, so a hull that isn't in local space pays nothing for it.
+struct HullPose
+{
+  Matrix3f rot, rotT ; // rotT undoes rot
+  Vector3f pos ;
+  bool moved ;
+  
+  HullPose() : moved( 0 ) {}
+  HullPose( const Matrix3f& iRot, const Vector3f& iPos ) : rot( iRot ), rotT( iRot ), pos( iPos ), moved( 1 ) {
+    rotT.transpose() ;
+  }
+  
+  // This pose, then rotating by r and translating by t
+  HullPose then( const Matrix3f& r, const Vector3f& t ) const {
+    if( !moved )  return HullPose( r, t ) ;
+    return HullPose( r*rot, r*pos + t ) ;
+  }
+  
+  Vector3f pt( const Vector3f& p ) const { return moved ? rot*p + pos : p ; }
+  Vector3f dir( const Vector3f& d ) const { return moved ? rot*d : d ; }
+  // and back again
+  Vector3f ptBack( const Vector3f& p ) const { return moved ? rotT*( p - pos ) : p ; }
+  Vector3f dirBack( const Vector3f& d ) const { return moved ? rotT*d : d ; }
+} ;
+
+// A point cloud you want a hull of, that you own.  Nothing is copied out of it until the hull is built.
+// The pts don't have to be packed: they can be the positions in an interleaved vertex buffer,
+// `stride` bytes apart, and they are read in place.
+struct PointCloudView
+{
+  const Vector3f* pts ;
+  int count ;
+  int stride ; // bytes from one pt to the next
+  
+  PointCloudView() : pts(0), count(0), stride(sizeof(Vector3f)) {}
+  PointCloudView( const Vector3f* iPts, int iCount ) : pts(iPts), count(iCount), stride(sizeof(Vector3f)) {}
+  PointCloudView( const vector<Vector3f>& iPts ) :
+    pts(iPts.size()?&iPts[0]:0), count((int)iPts.size()), stride(sizeof(Vector3f)) {}
+  
+  // Raw interleaved buffer, firstPos is the position of the 1st vertex
+  PointCloudView( const Vector3f* firstPos, int iCount, int iStride ) : pts(firstPos), count(iCount), stride(iStride) {}
+  
+  // The positions of any vertex type with a Vector3f `pos` (VertexPNC, VertexPcNCT..)
+  template <typename T> PointCloudView( const vector<T>& vertices ) :
+    pts(vertices.size()?&vertices[0].pos:0), count((int)vertices.size()), stride(sizeof(T)) {}
+  
+  inline const Vector3f& operator[]( int i ) const {
+    return *(const Vector3f*)( (const char*)pts + (size_t)i*stride ) ;
+  }
+} ;
+
 // The interface of this class is really Vector3f.  You pass in Vector3f's to
 // specify the point cloud via addPtToBound(Vector3f), then you call hull.expandToContainAllPts().
 // After you are all done, the hull's points are in hull.finalPts and hull.finalNormals.
@@ -87,33 +215,168 @@ struct Hull
 
   // indices of the actual hull.  in creating the convex hull no new vertices are added,
   // only _different points_ of the original point cloud's points may be used in specifying the hull.
+  // This flat index buffer is built from the mesh (below) by getFinalPts, once the hull is done.
   vector<int> indices ;
+  
+  // The hull's mesh.  he[3f], he[3f+1], he[3f+2] are the half-edges of faces[f].
+  // This is what the hull is built in, and it stays around after solve()
+  // so you can walk face adjacency (see faceNeighbour).
+  vector<HalfEdge> he ;
+  vector<HullFace> faces ;
+  vector<int> freeFaces ;    // dead slots in faces, reused by addTri
+  vector<int> pendingFaces ; // faces that got pts in their outside set. may be stale.
+  int visitStamp ;
+  int faceSerial ; // # faces ever made
+  
+  // Face planes cached when each face is created (SoA, indexed by face slot), so a
+  // visibility test is a single dot product instead of rebuilding a Plane from 3 verts.
+  vector<float> faceNx, faceNy, faceNz, faceD ;
+  // The same planes in double, only filled in when buildInDouble is set.
+  vector<double> faceNxd, faceNyd, faceNzd, faceDd ;
+  // and the precomputed barycentric data for closest-pt-on-face queries (distanceToClosestTriIB).
+  vector<PrecomputedTriangle> faceTris ;
+  
+  // finalFaces[i] is the mesh face that finalTris[i] was made from.
+  vector<int> finalFaces ;
+  
+  // finalPts[i] is verts[finalPtVerts[i]]
+  vector<int> finalPtVerts ;
+  
+  // finalNormals[finalTriNormals[i]] is the normal used for finalTris[i], and
+  // finalNormalRefs[j] counts the finalTris using finalNormals[j].  (for insertPoints)
+  vector<int> finalTriNormals, finalNormalRefs ;
+  
+  // The hull's flat faces (mergeCoplanarFaces).  A box is 6 of these instead of 12 tris.
+  // transformedPlanes[i] is finalPolys[i].plane moved with the transformed* set.
+  vector<HullPolygon> finalPolys ;
+  mutable vector<Plane> transformedPlanes ;
+  
+  // The hull's edges (findFinalEdges), and the distinct edge directions (up to sign) for the
+  // edge x edge axes of SAT, the same way finalNormals has the distinct face normals.
+  vector<HullEdge> finalEdges ;
+  vector<Vector3f> finalEdgeDirs ;
+  mutable vector<Vector3f> transformedEdgeDirs ;
+  
+  // Which finalPts are joined by an edge of the hull's mesh (diagonals in polygons included), for
+  // support()'s hill climbing.  finalPts[i]'s are ptNeighbours[ ptNeighbourStart[i] .. ptNeighbourStart[i+1] ).
+  vector<int> ptNeighbourStart, ptNeighbours ;
+  
+  // facePoly[f] is the polygon mesh face f went in, while finalTris are being made
+  vector<int> facePoly ;
 
   //AABB aabb ; // used to find pts closest to AABB corners.
   vector<int> remIndices ; // candidate pts for the hull when being constructed.
   
+  // inputVerts[i] is the vert that the i'th pt given to addPtToBound/addPtsToBound/insertPoints
+  // ended up as (pts that got welded share a vert), or -1 if insertPoints dropped it as inside.
+  // rebuildWarm uses it to find where each vert went.
+  vector<int> inputVerts ;
+  
+  // When set (the default), solve() uses the conflict-list QuickHull
+  // (expandToContainAllPtsConflict) instead of rescanning every remaining
+  // pt against every face on each iteration (expandToContainAllPts).
+  bool useConflictLists ;
+  
+  // When set (the default), the seed is grown out to all 14 extreme pts (the 6 axis extremes
+  // and the 8 pts closest to the AABB corners) and every pt inside that polytope is thrown
+  // out in one pass before the main loop (cullInteriorPts).
+  bool cullInterior ;
+  
+  // When set, the face planes are worked out in double and every distance test made while
+  // building (visibility, conflict lists, culling) is done in double.  A float plane far out
+  // (world coords of tens of km) is off by more than a small tolerance, so the hull comes out
+  // wrong or needs a big, coarse tolerance.  The results (finalPts, finalTris, ..) are float as usual.
+  bool buildInDouble ;
+  
+  // When set, every is-this-pt-outside-that-face decision made while building goes through
+  // the exact orient3d predicate (Predicates.h) instead of comparing a float distance to
+  // tolerance, so near coplanar pts can't make a face come out backwards.  tolerance isn't
+  // used, a pt is outside a face only if it is strictly in front of it.  The interior cull
+  // pass is skipped, its float planes can't be made exact.
+  bool exactPredicates ;
+  
+  // Whether construction failures get drawn with addPermDebug*.  The debug draw lists are
+  // globals, so hulls being built on worker threads (solveParallel) turn this off.
+  bool debugDraw ;
+  
+  // Whether construction problems get logged.  The sub-hulls of solveParallel turn this off: a thin
+  // slab often has too few distinct extreme corners, which is expected there, and logging from
+  // several workers at once isn't thread safe.
+  bool quiet ;
+  
   // Keep a transformed set, for each frame.  if you are a drifter then
   // the transformedPts set should be just re-transformed.  For pilots,
   // the transformedPts grouping 
   // The UNIQUE set of hull points
-  vector<Vector3f> finalPts, transformedPts ;
+  vector<Vector3f> finalPts ;
+  mutable vector<Vector3f> transformedPts ;
+  // transformedPts again as x, y and z arrays, for the SIMD SATtest.  Every transform*
+  // function keeps it up to date: call syncTransformedSoA() if you change transformedPts yourself.
+  mutable PointsSoA transformedSoA ;
+  
+  // LOCAL SPACE.  When set, the transform* functions don't touch the transformed* arrays: they
+  // stay a copy of the final* ones (the hull where it was built) and the move only goes in pose.
+  // Each query takes what it's given over into my space instead (an axis, ray, sphere center,
+  // tri, the other hull's pose) and what it gives back out again.  So moving a body costs O(1),
+  // and only the ones that get queried pay anything.  Only rigid moves can go in a pose: scale
+  // or shear in a matrix passed to transform* is lost.  Turn it on/off with setLocalSpace.
+  bool localSpace ;
+  HullPose pose ;
+  
+  // The move from the final* arrays to the transformed* ones.  Every transform* function keeps it
+  // up to date (except in local space, where the arrays stay put and it stays the identity).
+  Matrix4f transformedMatrix ;
+  
+  // Where the hull is (pose in local space, transformedMatrix otherwise) as a RigidTransform,
+  // while isRigid.  Only the RigidTransform moves keep it: any Matrix4f/Matrix3f one clears isRigid.
+  // transformTransformed( RigidTransform ) composes onto it and redoes the arrays from the final*
+  // ones, so a body moved that way every frame never drifts off rigid the way repeated
+  // transformTransformed( Matrix4f ) calls do.
+  RigidTransform rigid ;
+  bool isRigid ;
+  
+  // LAZY TRANSFORMS.  When set (and not in local space), the transform* functions only compose
+  // the move into transformedMatrix and mark every transformed* array stale.  Each array is then
+  // brought up to date on its own, from the final* one, the first time a query needs it
+  // (see materialize).  So moving several times before a query costs 1 transform of what that
+  // query reads, and an array no query reads (transformedTris for hull-hull) isn't touched at all.
+  // Turn it on/off with setLazyTransforms.
+  // That's why the transformed* arrays, transformedSoA, staleArrays and materializations are
+  // mutable: they're a cache of the final* arrays moved by transformedMatrix, and a const query
+  // can bring it up to date.
+  bool lazyTransforms ;
+  enum TransformedArray {
+    TransformedPts = 1, TransformedSoA = 2, TransformedNormals = 4, TransformedTris = 8,
+    TransformedPlanes = 16, TransformedEdgeDirs = 32, AllTransformed = 63, NumTransformedArrays = 6
+  } ;
+  mutable int staleArrays ; // TransformedArray bits behind transformedMatrix
+  
+  // For lazy transforms: the # of moves made, and the # of arrays brought up to date since.
+  // Moving eagerly would have redone all NumTransformedArrays on every move.
+  long long lazyMoves ;
+  mutable long long materializations ;
+  long long avoidedMaterializations() const { return lazyMoves*NumTransformedArrays - materializations ; }
   
   // The group of triangles representing the final convex hull.
   vector<Triangle> finalTris ;
   
   // So, the same hull will be hit multiple times.
-  vector<PrecomputedTriangle> transformedTris ;
+  mutable vector<PrecomputedTriangle> transformedTris ;
   
   // The group of distinct normals on the final convex hull.
   // if two normals are __very similar__, (two coplanar tris) then they
   // are considered as 1 normal.  That means one less axis to test in SAT testing,
   // since SAT only uses face normals and not actual Triangle position in space.
-  vector<Vector3f> finalNormals, transformedNormals ;
+  vector<Vector3f> finalNormals ;
+  mutable vector<Vector3f> transformedNormals ;
   
   // This is the distance that is tolerable for pts to be conisdered inside
   // the hull while they are really outside it.
   float tolerance ;
   
+  // After solveApprox, how far outside the hull a pt of the cloud can be.  0 for an exact hull.
+  float approxError ;
+  
   // the extreme pts go in the hull to start
   //Vector3f N[3]={ HUGE,HUGE,HUGE }, P[3]={-HUGE,-HUGE,-HUGE} ; // mins, maxes
   
@@ -138,11 +401,19 @@ struct Hull
     defaults() ;
     
     // I make sure to eliminate pts that are within a tolerence of each other (NO DUPES)
-    for( int i = 0 ; i < initialPts.size() ; i++ )
-      addPtToBound( initialPts[i] ) ;
+    if( initialPts.size() )
+      addPtsToBound( &initialPts[0], initialPts.size() ) ;
       
     solve() ;
   }
+  
+  // Same, but the pts can be read straight out of a vertex buffer, see PointCloudView.
+  Hull( const PointCloudView& initialPts )
+  {
+    defaults() ;
+    addPtsToBound( initialPts ) ;
+    solve() ;
+  }
 
   void defaults(){
     tolerance = 0.5 ; // THE BIGGER YOU SET THIS, THE MORE LIKELY
@@ -151,14 +422,35 @@ struct Hull
     // ANY STAGE, IT IS CONSIDERED "INSIDE" THE HULL AND ITS DISCARDED WITHOUT
     // ACTUALLY BOUNDING IT.  YOU CAN RAISE THIS NUMBER TO COME UP WITH
     // MORE COARSE (FEWER TRIS) BUT STILL KIND OF ACCURATE HULLS.
+    
+    approxError = 0.f ;
+    useConflictLists = 1 ;
+    cullInterior = 1 ;
+    buildInDouble = 0 ;
+    exactPredicates = 0 ;
+    debugDraw = 1 ;
+    quiet = 0 ;
+    localSpace = 0 ;
+    isRigid = 1 ;
+    lazyTransforms = 0 ;
+    staleArrays = 0 ;
+    lazyMoves = materializations = 0 ;
+    visitStamp = 0 ;
+    faceSerial = 0 ;
   }
   
   // clear out all old information
   void clear()
   {
-    verts.clear() ;  indices.clear() ;  remIndices.clear() ;
-    finalPts.clear() ;  finalNormals.clear() ;  finalTris.clear() ;
+    verts.clear() ;  indices.clear() ;  remIndices.clear() ;  inputVerts.clear() ;  clearMesh() ;
+    clearFinal() ;
+    transformedPts.clear() ;  transformedNormals.clear() ;  transformedTris.clear() ;  transformedPlanes.clear() ;
+    transformedEdgeDirs.clear() ;  transformedSoA = PointsSoA() ;
+    transformedMatrix = Matrix4f() ;  staleArrays = 0 ;
+    rigid = RigidTransform() ;  isRigid = 1 ;
+    extremeCorners.clear() ;
     aabb = AABB() ;
+    approxError = 0.f ;
   }
 
   // THE PUBLIC INTERFACE:
@@ -167,29 +459,592 @@ struct Hull
     // I'll only add it if its unique. insert each point only once.
     // If we get past this for loop the pt will be added.
     for( int i = 0 ; i < verts.size() ; i++ )
-      if( verts[i].isNear( pt ) ) 
+      if( verts[i].isNear( pt ) ) {
+        inputVerts.push_back( i ) ;
         return ;//we had pt already
+      }
     verts.push_back( pt ) ; // is a UNIQUE vertex of the submesh.
+    inputVerts.push_back( (int)verts.size()-1 ) ;
+  }
+  
+  // Bulk addPtToBound.  Same unique-vertex rule (a pt isNear an existing vert is dropped),
+  // but the candidates come from a hashed uniform grid instead of scanning all of verts,
+  // so loading a cloud is near linear instead of O(n^2).
+  void addPtsToBound( const Vector3f* pts, size_t n ) {
+    addPtsToBound( PointCloudView( pts, (int)n ) ) ;
+  }
+  
+  void addPtsToBound( const PointCloudView& pts )
+  {
+    int n = pts.count ;
+    // Cells are 2*EPS_MIN wide, so the pts near enough to weld with a pt are in its own cell
+    // or the one next to it on the side it is closer to: 2 cells per axis, 8 cells to look in.
+    const double cellSize = 2.0*EPS_MIN ;
+    
+    // hashed cell -> first vert in it.  nextInCell chains the rest.
+    // Different cells that hash the same just share a chain, isNear sorts them out.
+    unordered_map<long long, int> cellHead ;
+    cellHead.reserve( verts.size() + n ) ;
+    vector<int> nextInCell ;
+    nextInCell.reserve( verts.size() + n ) ;
+    
+    for( int i = 0 ; i < verts.size() ; i++ )
+      weldGridInsert( cellHead, nextInCell, i, cellSize ) ;
+    
+    for( int p = 0 ; p < n ; p++ )
+    {
+      const Vector3f& pt = pts[p] ;
+      long long c[3], side[3] ;
+      for( int axis = 0 ; axis < 3 ; axis++ )
+      {
+        double cell = pt.elts[axis] / cellSize ;
+        c[axis] = (long long)floor( cell ) ;
+        side[axis] = ( cell - c[axis] < 0.5 ) ? -1 : 1 ; // closer to the low or high wall of its cell
+      }
+      
+      int had = -1 ;
+      for( int k = 0 ; had == -1 && k < 8 ; k++ )
+      {
+        unordered_map<long long, int>::const_iterator iter = cellHead.find( weldCellKey(
+          c[0] + ((k&1)?side[0]:0), c[1] + ((k&2)?side[1]:0), c[2] + ((k&4)?side[2]:0) ) ) ;
+        if( iter == cellHead.end() )  skip ;
+        for( int i = iter->second ; i != -1 ; i = nextInCell[i] )
+          if( verts[i].isNear( pt ) ) {
+            had = i ; //we had pt already
+            break ;
+          }
+      }
+      
+      if( had != -1 ) {
+        inputVerts.push_back( had ) ;
+        skip ;
+      }
+      verts.push_back( pt ) ; // is a UNIQUE vertex of the submesh.
+      inputVerts.push_back( (int)verts.size()-1 ) ;
+      weldGridInsert( cellHead, nextInCell, (int)verts.size()-1, cellSize ) ;
+    }
   }
 
   void solve()
   {
     initFromExtremePts() ;
-    expandToContainAllPts() ;
+    if( useConflictLists )
+      expandToContainAllPtsConflict() ;
+    else
+      expandToContainAllPts() ;
+  }
+  
+  // Multi-threaded solve(), numThreads=0 means one thread per hardware thread.
+  void solveParallel( int numThreads=0 ) {
+    ThreadPool pool( numThreads ) ;
+    solveParallel( pool ) ;
+  }
+  
+  // Divide and conquer: verts are cut into slabs along the longest axis of their AABB,
+  // the hull of each slab is built on the pool, and then the final hull is built from
+  // the same seed solve() uses, but only the sub-hulls' verts are candidates.
+  // A pt that some sub-hull dropped is inside that sub-hull (to within tolerance),
+  // so it is inside the final hull too.
+  void solveParallel( ThreadPool& pool )
+  {
+    // Small clouds aren't worth splitting up.
+    const int MinPtsPerThread = 4096 ;
+    if( pool.size() == 1 || verts.size() < pool.size()*MinPtsPerThread ) {
+      solve() ;
+      return ;
+    }
+    
+    initFromExtremePts() ; // the seed is the one solve() would use
+    
+    // More slabs than threads, so a thread that got a sparse slab goes and takes another.
+    int numSlabs = 4*pool.size() ;
+    Vector3f extents = aabb.max - aabb.min ;
+    int axis = 0 ;
+    if( extents.y > extents.elts[axis] )  axis = 1 ;
+    if( extents.z > extents.elts[axis] )  axis = 2 ;
+    
+    // Only what's left in remIndices (after cullInteriorPts) gets split up.
+    vector< vector<int> > slabs( numSlabs ) ;
+    float slabWidth = extents.elts[axis] / numSlabs ;
+    for( int i = 0 ; i < remIndices.size() ; i++ )
+    {
+      const Vector3f& pt = verts[remIndices[i]] ;
+      int slab = (slabWidth > 0.f) ? (int)( (pt.elts[axis] - aabb.min.elts[axis]) / slabWidth ) : 0 ;
+      slabs[ clamp( slab, 0, numSlabs-1 ) ].push_back( remIndices[i] ) ;
+    }
+    
+    // Replace each slab's pts with just the ones on that slab's hull.
+    pool.parallelFor( numSlabs, [&]( int s, int threadNo ) {
+      vector<int>& slab = slabs[s] ;
+      if( slab.size() < 4 )  return ; // too few to hull, they all stay candidates
+      
+      Hull sub ;
+      sub.tolerance = 0.01f*tolerance ; // keep every pt that might be on the final hull
+      sub.debugDraw = 0 ;
+      sub.quiet = 1 ;
+      sub.buildInDouble = buildInDouble ;
+      sub.exactPredicates = exactPredicates ;
+      for( int i = 0 ; i < slab.size() ; i++ )
+        sub.verts.push_back( verts[slab[i]] ) ; // already unique, no welding needed
+      sub.solve() ;
+      
+      set<int> onHull( sub.indices.begin(), sub.indices.end() ) ;
+      vector<int> kept ;
+      for( set<int>::iterator iter = onHull.begin() ; iter != onHull.end() ; ++iter )
+        kept.push_back( slab[*iter] ) ;
+      slab.swap( kept ) ;
+    } ) ;
+    
+    remIndices.clear() ;
+    for( int s = 0 ; s < numSlabs ; s++ )
+      remIndices.insert( remIndices.end(), slabs[s].begin(), slabs[s].end() ) ;
+    
+    if( useConflictLists )
+      expandToContainAllPtsConflict() ;
+    else
+      expandToContainAllPts() ;
+  }
+  
+  // Walking the mesh.
+  // The half-edge after e in e's face
+  static inline int nextHE( int e ) {
+    return e - e%3 + (e+1)%3 ;
+  }
+  
+  inline int faceVert( int f, int k ) const {
+    return he[3*f+k].vert ;
+  }
+  
+  // The face on the other side of face f's k'th edge (edge faceVert(f,k)---faceVert(f,k+1)).
+  // -1 if the mesh is open there (only happens with a degenerate seed).
+  inline int faceNeighbour( int f, int k ) const {
+    int twin = he[3*f+k].twin ;
+    return twin==-1 ? -1 : twin/3 ;
+  }
+  
+  Plane facePlane( int f ) const {
+    return Plane( Vector3f( faceNx[f], faceNy[f], faceNz[f] ), -faceD[f] ) ;
+  }
+  
+  // Signed distance from face f's plane to pt, off the cached plane.
+  inline float faceDistance( int f, const Vector3f& pt ) const {
+    if( buildInDouble )
+      return (float)( faceNxd[f]*pt.x + faceNyd[f]*pt.y + faceNzd[f]*pt.z + faceDd[f] ) ;
+    return faceNx[f]*pt.x + faceNy[f]*pt.y + faceNz[f]*pt.z + faceD[f] ;
+  }
+  
+  // Whether pt is outside face f: more than tolerance in front of it,
+  // or with exactPredicates, strictly in front of it.
+  inline bool faceSees( int f, const Vector3f& pt ) const {
+    if( exactPredicates )
+      return orient3d( verts[faceVert(f,0)], verts[faceVert(f,1)], verts[faceVert(f,2)], pt ) < 0.0 ;
+    return faceDistance( f, pt ) > tolerance ;
+  }
+
+  // Grows a finished hull to take in more pts (in the same space as the pts it was built from).
+  // Each pt is checked against the hull's faces, and the ones inside (to within tolerance) are
+  // rejected right there, they never even go in verts.  The rest go through the same conflict list
+  // expansion solve() uses, and then only the final* entries of faces that came or went are touched.
+  // The transformed* arrays come back in hull space like after solve(), so transform() again
+  // if you had moved the hull.  Returns the # of pts that were outside.
+  int insertPoints( const PointCloudView& pts )
+  {
+    int n = pts.count ;
+    int serialBefore = faceSerial ;
+    
+    // 1) reject inside pts, the others go in the outside set of the face they're furthest out of.
+    vector<int> outsidePts ;
+    for( int i = 0 ; i < n ; i++ )
+    {
+      int bestFace = -1 ;
+      float bestDist = exactPredicates ? -HUGE : tolerance ;
+      for( int j = 0 ; j < finalFaces.size() ; j++ )
+      {
+        float dist = faceDistance( finalFaces[j], pts[i] ) ;
+        if( dist > bestDist && ( !exactPredicates || faceSees( finalFaces[j], pts[i] ) ) ) {
+          bestDist = dist ;
+          bestFace = finalFaces[j] ;
+        }
+      }
+      if( bestFace == -1 ) {
+        inputVerts.push_back( -1 ) ;
+        skip ;
+      }
+      
+      if( faces[bestFace].outside.empty() )
+        pendingFaces.push_back( bestFace ) ;
+      faces[bestFace].outside.push_back( (int)verts.size() ) ;
+      inputVerts.push_back( (int)verts.size() ) ;
+      verts.push_back( pts[i] ) ;
+      outsidePts.push_back( (int)verts.size()-1 ) ;
+      
+      // it may end up on the hull, so grow the bounds to hold it (mergeCoplanarFaces sizes its eps from the aabb)
+      aabb.bound( pts[i] ) ;
+      for( int axis = 0 ; axis < 3 ; axis++ )
+      {
+        if( verts.back().elts[axis] < verts[mins[axis]].elts[axis] )
+          mins[axis] = (int)verts.size()-1 ;
+        if( verts.back().elts[axis] > verts[maxes[axis]].elts[axis] )
+          maxes[axis] = (int)verts.size()-1 ;
+      }
+    }
+    if( outsidePts.empty() )  return 0 ;
+    
+    // 2) expand, exactly as in construction
+    expandConflictFaces() ;
+    
+    // 3) drop the tris of faces that died.  A face made before this call is still the
+    // same face if its slot is alive and wasn't recycled.
+    int w = 0 ;
+    for( int i = 0 ; i < finalTris.size() ; i++ )
+    {
+      int f = finalFaces[i] ;
+      if( faces[f].alive && faces[f].serial < serialBefore )
+      {
+        finalTris[w] = finalTris[i] ;
+        finalFaces[w] = f ;
+        finalTriNormals[w] = finalTriNormals[i] ;
+        w++ ;
+      }
+      else
+        finalNormalRefs[ finalTriNormals[i] ]-- ;
+    }
+    finalTris.resize( w ) ;  finalFaces.resize( w ) ;  finalTriNormals.resize( w ) ;
+    
+    // Normals nobody uses anymore go too
+    vector<int> normalRemap( finalNormals.size(), -1 ) ;
+    w = 0 ;
+    for( int j = 0 ; j < finalNormals.size() ; j++ )
+    {
+      if( !finalNormalRefs[j] )  skip ;
+      finalNormals[w] = finalNormals[j] ;
+      finalNormalRefs[w] = finalNormalRefs[j] ;
+      normalRemap[j] = w++ ;
+    }
+    finalNormals.resize( w ) ;  finalNormalRefs.resize( w ) ;
+    for( int i = 0 ; i < finalTriNormals.size() ; i++ )
+      finalTriNormals[i] = normalRemap[ finalTriNormals[i] ] ;
+    
+    // 4) add the tris of the new faces that survived.  The polygons are all redone
+    // below, so the new tris get normals of their own.
+    facePoly.clear() ;
+    vector<bool> onHull( verts.size(), 0 ) ;
+    for( int f = 0 ; f < faces.size() ; f++ )
+    {
+      if( !faces[f].alive )  skip ;
+      for( int k = 0 ; k < 3 ; k++ )
+        onHull[ faceVert(f,k) ] = 1 ;
+      if( faces[f].serial >= serialBefore )
+        addFinalTri( f ) ;
+    }
+    
+    // 5) and the same for the pts: keep the ones still on the hull, add the new ones.
+    w = 0 ;
+    for( int i = 0 ; i < finalPtVerts.size() ; i++ )
+    {
+      if( !onHull[ finalPtVerts[i] ] )  skip ;
+      finalPtVerts[w] = finalPtVerts[i] ;
+      finalPts[w] = finalPts[i] ;
+      w++ ;
+    }
+    finalPtVerts.resize( w ) ;  finalPts.resize( w ) ;
+    for( int i = 0 ; i < outsidePts.size() ; i++ )
+      if( onHull[ outsidePts[i] ] ) {
+        finalPtVerts.push_back( outsidePts[i] ) ;
+        finalPts.push_back( verts[outsidePts[i]] ) ;
+      }
+    
+    indices.clear() ;
+    for( int i = 0 ; i < finalFaces.size() ; i++ )
+      for( int k = 0 ; k < 3 ; k++ )
+        indices.push_back( faceVert( finalFaces[i], k ) ) ;
+    
+    // 6) the polygons, each takes the normal of one of its tris
+    mergeCoplanarFaces() ;
+    for( int i = 0 ; i < finalFaces.size() ; i++ )
+      finalPolys[ facePoly[ finalFaces[i] ] ].normal = finalTriNormals[i] ;
+    findFinalEdges() ;
+    
+    copyFinalToTransformed() ;
+    return (int)outsidePts.size() ;
+  }
+  
+  inline int insertPoints( const Vector3f* pts, int n ) {
+    return insertPoints( PointCloudView( pts, n ) ) ;
+  }
+
+  // Rebuilds the hull after the pts it was built from moved a little (jitter, a deforming cloud):
+  // pts[i] is where the i'th pt that went into the hull (see inputVerts) is now.
+  // The last hull's verts and seed tet are reused, and of the other pts only the ones that
+  // could have moved outside are candidates.  If none of the last hull's verts moved more than m,
+  // the hull of where they are now still holds the last hull shrunk by m: so a pt now more than m
+  // inside every face of the last hull can't be on the new one.  The planes are bucketed on a
+  // coarse grid so each pt only tries the few that pass near its cell.
+  // If the # of pts changed, it's just a full rebuild.
+  void rebuildWarm( const PointCloudView& pts )
+  {
+    int n = pts.count ;
+    if( n != inputVerts.size() || finalPtVerts.empty() || extremeCorners.size() != 8 )
+    {
+      clear() ;
+      addPtsToBound( pts ) ;
+      solve() ;
+      return ;
+    }
+
+    // 1) The last hull's planes, before the seed below replaces the mesh
+    vector<double> oldPlanes ; // nx, ny, nz, d for each face
+    for( int i = 0 ; i < finalFaces.size() ; i++ )
+    {
+      int f = finalFaces[i] ;
+      if( buildInDouble ) {
+        oldPlanes.push_back( faceNxd[f] ) ;  oldPlanes.push_back( faceNyd[f] ) ;  oldPlanes.push_back( faceNzd[f] ) ;  oldPlanes.push_back( faceDd[f] ) ;
+      }
+      else {
+        oldPlanes.push_back( faceNx[f] ) ;  oldPlanes.push_back( faceNy[f] ) ;  oldPlanes.push_back( faceNz[f] ) ;  oldPlanes.push_back( faceD[f] ) ;
+      }
+    }
+    int numOldPlanes = (int)finalFaces.size() ;
+
+    // 2) Move the verts.  pts that were welded together but have come apart
+    // become verts of their own, and those have no old spot so are always candidates.
+    vector<Vector3f> movedVerts( verts ) ;
+    vector<bool> moved( verts.size(), 0 ) ;
+    vector<int> freshVerts ;
+    for( int i = 0 ; i < n ; i++ )
+    {
+      int v = inputVerts[i] ;
+      if( v != -1 && !moved[v] )
+      {
+        movedVerts[v] = pts[i] ;
+        moved[v] = 1 ;
+      }
+      else if( v == -1 || !movedVerts[v].isNear( pts[i] ) )
+      {
+        inputVerts[i] = (int)movedVerts.size() ;
+        freshVerts.push_back( (int)movedVerts.size() ) ;
+        movedVerts.push_back( pts[i] ) ;
+      }
+    }
+    // only the last hull's verts matter for m
+    float maxMove2 = 0.f ;
+    for( int i = 0 ; i < finalPtVerts.size() ; i++ )
+      maxMove2 = max( maxMove2, distance2( movedVerts[ finalPtVerts[i] ], verts[ finalPtVerts[i] ] ) ) ;
+    float maxMove = sqrtf( maxMove2 ) ;
+    verts.swap( movedVerts ) ;
+
+    // 3) same seed tet as last time, if it's still a tet
+    int c1=extremeCorners[1], c2=extremeCorners[2], c4=extremeCorners[4], c7=extremeCorners[7] ;
+    findExtreme() ; // new aabb, mins, maxes.  remIndices gets every vert, which we filter next.
+    if( fabsf( Plane( verts[c1], verts[c4], verts[c7] ).distanceToPoint( verts[c2] ) ) <= tolerance )
+      initFrom4Tet() ; // went flat, pick new corners
+    else
+      initFromExtremeCorners() ;
+
+    // 4) the candidates: the last hull's verts, the fresh verts and the other pts within m of some
+    // face of the last hull, or out past it.  The new AABB is cut into cells, and each cell lists
+    // the planes that some pt in it could be within m of (a few near the surface, none deep inside).
+    int gridRes = max( 2, min( 16, (int)( 0.9f*powf( (float)n, 0.2f ) ) ) ) ;
+    Vector3f cellSize = ( aabb.max - aabb.min ) / (float)gridRes ;
+    double slack[3] ; // cells are padded a little for pts that round into the next one over
+    for( int axis = 0 ; axis < 3 ; axis++ )
+      slack[axis] = 0.01*cellSize.elts[axis] + 1e-6*max( fabsf( aabb.min.elts[axis] ), fabsf( aabb.max.elts[axis] ) ) ;
+    vector<int> cellStart( gridRes*gridRes*gridRes + 1 ) ;
+    vector<double> cellPlanes ; // copies, so a cell's planes are together
+    for( int cell = 0 ; cell < gridRes*gridRes*gridRes ; cell++ )
+    {
+      cellStart[cell] = (int)cellPlanes.size() / 4 ;
+      int c[3] = { cell % gridRes, ( cell / gridRes ) % gridRes, cell / ( gridRes*gridRes ) } ;
+      double mid[3], half[3] ;
+      for( int axis = 0 ; axis < 3 ; axis++ )
+      {
+        mid[axis] = aabb.min.elts[axis] + ( c[axis] + 0.5 )*cellSize.elts[axis] ;
+        half[axis] = 0.5*cellSize.elts[axis] + slack[axis] ;
+      }
+      for( int j = 0 ; j < numOldPlanes ; j++ )
+      {
+        const double* plane = &oldPlanes[ 4*j ] ;
+        double top = plane[3] ; // furthest out of plane j any pt in the cell can be
+        for( int axis = 0 ; axis < 3 ; axis++ )
+          top += plane[axis]*mid[axis] + fabs( plane[axis] )*half[axis] ;
+        if( top > -maxMove )
+          cellPlanes.insert( cellPlanes.end(), plane, plane + 4 ) ;
+      }
+    }
+    cellStart.back() = (int)cellPlanes.size() / 4 ;
+    
+    Vector3f cellsPerUnit ;
+    for( int axis = 0 ; axis < 3 ; axis++ )
+      cellsPerUnit.elts[axis] = cellSize.elts[axis] > 0.f ? 1.f / cellSize.elts[axis] : 0.f ;
+    vector<bool> candidate( verts.size(), 0 ) ;
+    for( int i = 0 ; i < finalPtVerts.size() ; i++ )
+      candidate[ finalPtVerts[i] ] = 1 ;
+    for( int i = 0 ; i < freshVerts.size() ; i++ )
+      candidate[ freshVerts[i] ] = 1 ;
+    // The other pts are bucketed by cell, so each cell's planes run over all of its pts in one go
+    // (no early out per pt: the trip count only changes from cell to cell, so the branches predict).
+    // All of them are at least 0 cells in (they're in the aabb), so only the top needs clamping.
+    vector<int> cellOf( verts.size() ), bucketStart( gridRes*gridRes*gridRes + 1, 0 ) ;
+    for( int i = 0 ; i < verts.size() ; i++ )
+    {
+      int cell = 0 ;
+      for( int axis = 2 ; axis >= 0 ; axis-- )
+        cell = cell*gridRes + min( gridRes-1, (int)( ( verts[i].elts[axis] - aabb.min.elts[axis] )*cellsPerUnit.elts[axis] ) ) ;
+      cellOf[i] = cell ;
+      bucketStart[cell+1]++ ;
+    }
+    for( int cell = 0 ; cell < gridRes*gridRes*gridRes ; cell++ )
+      bucketStart[cell+1] += bucketStart[cell] ;
+    vector<int> bucketed( verts.size() ), bucketFill( bucketStart.begin(), bucketStart.end() - 1 ) ;
+    for( int i = 0 ; i < verts.size() ; i++ )
+      bucketed[ bucketFill[ cellOf[i] ]++ ] = i ;
+    
+    remIndices.clear() ;
+    for( int cell = 0 ; cell < gridRes*gridRes*gridRes ; cell++ )
+    {
+      int first = cellStart[cell], last = cellStart[cell+1] ;
+      if( first == last )  skip ; // deep inside: every pt in it goes
+      for( int k = bucketStart[cell] ; k < bucketStart[cell+1] ; k++ )
+      {
+        const Vector3f& pt = verts[ bucketed[k] ] ;
+        double furthest = -HUGE ;
+        for( int j = first ; j < last ; j++ )
+        {
+          const double* plane = &cellPlanes[ 4*j ] ;
+          furthest = max( furthest, plane[0]*pt.x + plane[1]*pt.y + plane[2]*pt.z + plane[3] ) ;
+        }
+        if( furthest > -maxMove && !candidate[ bucketed[k] ] )
+          remIndices.push_back( bucketed[k] ) ;
+      }
+    }
+    for( int i = 0 ; i < verts.size() ; i++ )
+      if( candidate[i] )
+        remIndices.push_back( i ) ;
+    
+    // Grow the seed out to the extreme pts first, as solve() does.  Starting QuickHull from just
+    // the tet loses pts on a thin cloud: its edges are so sharp that a pt within tolerance of
+    // every face plane can be well outside it.
+    if( cullInterior )
+      cullInteriorPts() ;
+
+    if( useConflictLists )
+      expandToContainAllPtsConflict() ;
+    else
+      expandToContainAllPts() ;
+  }
+
+  inline void rebuildWarm( const Vector3f* pts, int n ) {
+    rebuildWarm( PointCloudView( pts, n ) ) ;
+  }
+
+  // Approximate hull of pts[0..n), for when you don't need the exact hull of a huge cloud (broadphase proxies).
+  // The cloud is cut into columns along its longest axis, on a grid over the other 2 axes, and only the
+  // lowest and highest pt of each column is kept.  Any pt is between those 2 in its column, so it is within
+  // one cell diagonal of the segment joining them, which is inside the hull.  Linear in n, and the hull is
+  // built from those few pts (in place of anything that was in the hull before).
+  // maxError is how far outside the hull a pt may be, not counting `tolerance`.  The grid is capped at
+  // MaxColumns, so a maxError that is too small for the cloud gets rounded up.
+  // Returns approxError, the bound that was actually met (cell diagonal + tolerance).
+  float solveApprox( const PointCloudView& pts, float maxError )
+  {
+    int n = pts.count ;
+    clear() ;
+    if( n <= 0 )
+    {
+      solve() ;
+      return approxError = tolerance ;
+    }
+
+    AABB box ;
+    for( int i = 0 ; i < n ; i++ )
+      box.bound( pts[i] ) ;
+    Vector3f extents = box.max - box.min ;
+    int axis = 0 ; // the columns run along the longest axis, so there are fewest of them
+    if( extents.y > extents.elts[axis] )  axis = 1 ;
+    if( extents.z > extents.elts[axis] )  axis = 2 ;
+    int u = (axis+1)%3, v = (axis+2)%3 ;
+
+    const double MaxColumns = 1<<22 ;
+    double cell = max( maxError, EPS_MIN ) / sqrt( 2.0 ) ;
+    // In double: extents/cell can be way past INT_MAX for a small maxError.  Grow the cell
+    // until the grid fits (more than once when one side is flat, and only 1 column wide).
+    double du = max( 1.0, ceil( extents.elts[u] / cell ) ), dv = max( 1.0, ceil( extents.elts[v] / cell ) ) ;
+    while( du*dv > MaxColumns )
+    {
+      cell *= sqrt( du*dv / MaxColumns ) * 1.01 ;
+      du = max( 1.0, ceil( extents.elts[u] / cell ) ) ;
+      dv = max( 1.0, ceil( extents.elts[v] / cell ) ) ;
+    }
+    int cu = (int)du, cv = (int)dv ;
+
+    // lowest and highest pt in each column
+    vector<int> lo( cu*cv, -1 ), hi( cu*cv, -1 ) ;
+    for( int i = 0 ; i < n ; i++ )
+    {
+      int iu = max( 0, min( cu-1, (int)( (pts[i].elts[u] - box.min.elts[u]) / cell ) ) ) ;
+      int iv = max( 0, min( cv-1, (int)( (pts[i].elts[v] - box.min.elts[v]) / cell ) ) ) ;
+      int col = iu*cv + iv ;
+      float h = pts[i].elts[axis] ;
+      if( lo[col] == -1 )
+        lo[col] = hi[col] = i ;
+      else if( h < pts[lo[col]].elts[axis] )
+        lo[col] = i ;
+      else if( h > pts[hi[col]].elts[axis] )
+        hi[col] = i ;
+    }
+
+    vector<Vector3f> kernel ;
+    for( int col = 0 ; col < lo.size() ; col++ )
+    {
+      if( lo[col] == -1 )  skip ;
+      kernel.push_back( pts[lo[col]] ) ;
+      if( hi[col] != lo[col] )
+        kernel.push_back( pts[hi[col]] ) ;
+    }
+
+    addPtsToBound( &kernel[0], kernel.size() ) ;
+    solve() ;
+    return approxError = (float)( cell*sqrt( 2.0 ) ) + tolerance ;
+  }
+
+  inline float solveApprox( const Vector3f* pts, int n, float maxError ) {
+    return solveApprox( PointCloudView( pts, n ), maxError ) ;
   }
 
 private:
+  static inline long long weldCellKey( long long cx, long long cy, long long cz ) {
+    return cx*73856093LL ^ cy*19349663LL ^ cz*83492791LL ;
+  }
+  
+  // Puts verts[i] at the head of its cell's chain in the welding grid
+  void weldGridInsert( unordered_map<long long, int>& cellHead, vector<int>& nextInCell, int i, double cellSize ) const
+  {
+    long long key = weldCellKey( (long long)floor( verts[i].x / cellSize ),
+      (long long)floor( verts[i].y / cellSize ), (long long)floor( verts[i].z / cellSize ) ) ;
+    unordered_map<long long, int>::iterator iter = cellHead.find( key ) ;
+    if( iter == cellHead.end() )
+    {
+      nextInCell.push_back( -1 ) ;
+      cellHead[ key ] = i ;
+    }
+    else
+    {
+      nextInCell.push_back( iter->second ) ;
+      iter->second = i ;
+    }
+  }
+  
   // Finds the initial set of extreme points for the hull.
   void findExtreme()
   {
     for( int i = 0 ; i < 3 ; i++ )  mins[i]=maxes[i]=0;
     indices.clear() ;
+    clearMesh() ;
     remIndices.clear() ;
     aabb = AABB() ;
     // find the extreme pts
     for( int i = 0 ; i < verts.size() ; i++ )
     {
-      aabb.bound( verts[ i ] ) ;
       remIndices.push_back( i ) ; // add the index to the indices to process.
       // Look for 6 pts that minimize and maximize x,y,z axes
       // find the 6 pts (may not be distinct) with:
@@ -202,6 +1057,9 @@ private:
           maxes[axis] = i ;
       }
     }
+    // the aabb is just the extreme pts (bounding vert by vert redoes its corners every time)
+    if( !verts.empty() )
+      aabb = AABB( Vector3f( verts[mins[0]].x, verts[mins[1]].y, verts[mins[2]].z ), Vector3f( verts[maxes[0]].x, verts[maxes[1]].y, verts[maxes[2]].z ) ) ;
     
     // The tolerance should be related to the extreme points
   }
@@ -272,18 +1130,37 @@ private:
     uniqueExtremeCorners.insert( extremeCorners[4] ) ;
     uniqueExtremeCorners.insert( extremeCorners[7] ) ;
     
-    if( uniqueExtremeCorners.size() != 4 )
+    if( uniqueExtremeCorners.size() != 4 && !quiet )
     {
       // Even if this happens, the convex hull still might come out correctly.
       warning( "Extreme corners bad, only %d of them, %d %d %d %d", uniqueExtremeCorners.size(),
         extremeCorners[1], extremeCorners[2], extremeCorners[4], extremeCorners[7] ) ;
     }
     
+    initFromExtremeCorners() ;
+  }
+  
+  // The seed tet from extremeCorners 1,2,4,7
+  void initFromExtremeCorners()
+  {
+    set<int> uniqueExtremeCorners ;
+    uniqueExtremeCorners.insert( extremeCorners[1] ) ;
+    uniqueExtremeCorners.insert( extremeCorners[2] ) ;
+    uniqueExtremeCorners.insert( extremeCorners[4] ) ;
+    uniqueExtremeCorners.insert( extremeCorners[7] ) ;
+    
+    // A thin or lopsided cloud (like a slab in solveParallel) can put the corner pts
+    // so the tet comes out wound inside out.  If 2 is in front of 1,4,7 swap 4 and 7.
+    int c1=extremeCorners[1], c2=extremeCorners[2], c4=extremeCorners[4], c7=extremeCorners[7] ;
+    if( uniqueExtremeCorners.size() == 4 && orient3d( verts[c1], verts[c4], verts[c7], verts[c2] ) < 0.0 )
+      ::swap( c4, c7 ) ;
+    
     // wind: 1,4,7 | 1,7,2 | 1,2,4 | 4,2,7
-    addTri( extremeCorners[1], extremeCorners[4], extremeCorners[7] ) ;
-    addTri( extremeCorners[1], extremeCorners[7], extremeCorners[2] ) ;
-    addTri( extremeCorners[1], extremeCorners[2], extremeCorners[4] ) ;
-    addTri( extremeCorners[4], extremeCorners[2], extremeCorners[7] ) ;
+    addTri( c1, c4, c7 ) ;
+    addTri( c1, c7, c2 ) ;
+    addTri( c1, c2, c4 ) ;
+    addTri( c4, c2, c7 ) ;
+    linkTwins() ;
   }
   
   void initFrom6AxisExtremes()
@@ -309,6 +1186,7 @@ private:
     addTri( N[2], N[0], P[1] ) ;
     addTri( N[2], N[1], N[0] ) ;
     addTri( N[2], P[0], N[1] ) ;
+    linkTwins() ;
   }
   
   void initFromExtremePts()
@@ -320,11 +1198,83 @@ private:
     // Check the hull is ok
     if( !convexityTest() )
     {
-      error( "BAD SEED HULL. Your hull will malfunction because the initial tetrahedron got fucked up. "
-        "Hullinator apologizes, but you have to give me better spread-out points." ) ;
+      if( !quiet )
+        error( "BAD SEED HULL. Your hull will malfunction because the initial tetrahedron got fucked up. "
+          "Hullinator apologizes, but you have to give me better spread-out points." ) ;
         
-      drawDebugExtremePts() ;
+      if( debugDraw )
+        drawDebugExtremePts() ;
     }
+    else if( cullInterior )
+      cullInteriorPts() ;
+  }
+  
+  // Akl-Toussaint: the extreme pts are on the hull, so any pt inside their hull isn't.
+  // The seed tet is grown out to the other extreme pts, then remIndices is cut down to the
+  // pts outside the grown seed.  For uniform or gaussian clouds that's most of them.
+  void cullInteriorPts()
+  {
+    int extremes[14] = { mins[0], mins[1], mins[2], maxes[0], maxes[1], maxes[2] } ;
+    for( int i = 0 ; i < 8 ; i++ )
+      extremes[6+i] = extremeCorners[i] ;
+    
+    for( int i = 0 ; i < 14 ; i++ )
+    {
+      bool outside = 0 ;
+      for( int f = 0 ; !outside && f < faces.size() ; f++ )
+        outside = faces[f].alive && faceSees( f, verts[extremes[i]] ) ;
+      if( outside )
+        expandToInclude( extremes[i] ) ;
+    }
+    if( exactPredicates )  return ;
+    
+    if( buildInDouble )
+      cullOutsidePlanes( faceNxd, faceNyd, faceNzd, faceDd ) ;
+    else
+      cullOutsidePlanes( faceNx, faceNy, faceNz, faceD ) ;
+  }
+  
+  // Keeps only the remIndices more than tolerance out of some live face, Real is the plane cache's type.
+  template <typename Real>
+  void cullOutsidePlanes( const vector<Real>& planeNx, const vector<Real>& planeNy, const vector<Real>& planeNz, const vector<Real>& planeD )
+  {
+    // Pack the planes of the polytope tight so the inner loop has no holes or branches
+    vector<Real> nx, ny, nz, d ;
+    for( int f = 0 ; f < faces.size() ; f++ )
+    {
+      if( !faces[f].alive )  skip ;
+      nx.push_back( planeNx[f] ) ;  ny.push_back( planeNy[f] ) ;  nz.push_back( planeNz[f] ) ;  d.push_back( planeD[f] ) ;
+    }
+    int numPlanes = (int)nx.size() ;
+    
+    // The pts go through in blocks, gathered into SoA, and each plane is run across a whole
+    // block at a time, so the inner loop is straight line code over contiguous floats.
+    // A pt within tolerance of the polytope would be dropped by the first assignment anyway.
+    const int BlockSize = 256 ;
+    Real x[BlockSize], y[BlockSize], z[BlockSize], furthest[BlockSize] ;
+    int w = 0 ;
+    for( int start = 0 ; start < remIndices.size() ; start += BlockSize )
+    {
+      int count = min( BlockSize, (int)remIndices.size() - start ) ;
+      for( int k = 0 ; k < count ; k++ )
+      {
+        const Vector3f& pt = verts[remIndices[start+k]] ;
+        x[k] = pt.x ;  y[k] = pt.y ;  z[k] = pt.z ;  furthest[k] = -HUGE ;
+      }
+      for( int j = 0 ; j < numPlanes ; j++ )
+      {
+        Real a = nx[j], b = ny[j], c = nz[j], dj = d[j] ;
+        for( int k = 0 ; k < count ; k++ )
+        {
+          Real dist = a*x[k] + b*y[k] + c*z[k] + dj ;
+          furthest[k] = dist > furthest[k] ? dist : furthest[k] ;
+        }
+      }
+      for( int k = 0 ; k < count ; k++ )
+        if( furthest[k] > tolerance )
+          remIndices[w++] = remIndices[start+k] ;
+    }
+    remIndices.resize( w ) ;
   }
   
   // This is the test to make sure you indeed HAVE A convex polygon.
@@ -332,155 +1282,515 @@ private:
   // in the shape.  if it does, a face is BACKWARDS.
   bool convexityTest() const
   {
-    for( int i = 0 ; i < indices.size() ; i+=3 )
+    for( int i = 0 ; i < faces.size() ; i++ )
     {
-      Plane plane( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]] ) ;
-      
-      for( int j = 0 ; j < indices.size() ; j++ )
+      if( !faces[i].alive )  skip ;
+      for( int j = 0 ; j < faces.size() ; j++ )
       {
-        if( i==j ) { j+=2 ; skip; } // don't test your verts against the tri you came out of.
-        if( plane.distanceToPoint( verts[indices[j]] ) > tolerance )
+        if( i==j || !faces[j].alive ) skip ; // don't test your verts against the tri you came out of.
+        for( int k = 0 ; k < 3 ; k++ )
         {
-          warning( "Your convex polygon is not convex." ) ;
-          addPermDebugPoint( verts[indices[j]], Red ) ;
-          addPermDebugTriLine( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]], Red ) ;
-          return 0 ;
+          if( faceSees( i, verts[faceVert(j,k)] ) )
+          {
+            if( !quiet )
+              warning( "Your convex polygon is not convex." ) ;
+            if( debugDraw ) {
+              addPermDebugPoint( verts[faceVert(j,k)], Red ) ;
+              addPermDebugTriLine( verts[faceVert(i,0)], verts[faceVert(i,1)], verts[faceVert(i,2)], Red ) ;
+            }
+            return 0 ;
+          }
         }
       }
     }
     return 1 ;
   }
   
+  void clearMesh() {
+    he.clear() ;  faces.clear() ;  freeFaces.clear() ;  pendingFaces.clear() ;
+    faceNx.clear() ;  faceNy.clear() ;  faceNz.clear() ;  faceD.clear() ;  faceTris.clear() ;
+    faceNxd.clear() ;  faceNyd.clear() ;  faceNzd.clear() ;  faceDd.clear() ;
+  }
+  
   // THIS IS THE ONLY WAY TO ADD A TRIANGLE TO THE HULL.
-  bool addTri( int ia, int ib, int ic ) {
+  // Returns the face's slot in `faces`, or -1 if the tri was degenerate.
+  // The new face's half-edges aren't linked to anything, you have to set the twins.
+  int addTri( int ia, int ib, int ic ) {
     if( ia==ib || ia==ic || ib==ic ){
       //warning( "Degenerate tri %d %d %d", ia, ib, ic ) ;
-      return 0 ; // degenerate
+      return -1 ; // degenerate
+    }
+    
+    // There you have a triangle added.  Recycle a dead slot if there is one.
+    int f ;
+    if( freeFaces.size() )
+    {
+      f = freeFaces.back() ;
+      freeFaces.pop_back() ;
+      faces[f].alive = 1 ;
+      faces[f].visit = -1 ;
+      he[3*f] = HalfEdge( ia ) ;  he[3*f+1] = HalfEdge( ib ) ;  he[3*f+2] = HalfEdge( ic ) ;
+    }
+    else
+    {
+      f = (int)faces.size() ;
+      faces.push_back( HullFace() ) ;
+      he.push_back( HalfEdge( ia ) ) ;  he.push_back( HalfEdge( ib ) ) ;  he.push_back( HalfEdge( ic ) ) ;
+      faceNx.push_back( 0.f ) ;  faceNy.push_back( 0.f ) ;  faceNz.push_back( 0.f ) ;  faceD.push_back( 0.f ) ;
+      faceNxd.push_back( 0.0 ) ;  faceNyd.push_back( 0.0 ) ;  faceNzd.push_back( 0.0 ) ;  faceDd.push_back( 0.0 ) ;
+      faceTris.push_back( PrecomputedTriangle() ) ;
     }
     
-    // There you have a triangle added.
-    indices.push_back( ia ) ;    indices.push_back( ib ) ;    indices.push_back( ic ) ;
+    faces[f].serial = faceSerial++ ;
+    
+    // The only time the plane of face f is computed.
+    faceTris[f] = PrecomputedTriangle( verts[ia], verts[ib], verts[ic] ) ;
+    const Plane& plane = faceTris[f].plane ;
+    faceNx[f] = plane.normal.x ;  faceNy[f] = plane.normal.y ;  faceNz[f] = plane.normal.z ;
+    faceD[f] = plane.d ;
+    if( buildInDouble )
+      computeFacePlaneDouble( f, verts[ia], verts[ib], verts[ic] ) ;
     //addDebugLine( debugPASS1 + tri.triCentroid(), debugPASS1 + tri.triCentroid() + tri.plane.normal*0.1f, Yellow ) ;
-    return 1 ;
+    return f ;
+  }
+  
+  // Face f's plane in double, same winding as Plane( a, b, c ), through the centroid.
+  void computeFacePlaneDouble( int f, const Vector3f& a, const Vector3f& b, const Vector3f& c )
+  {
+    double abx = (double)b.x - a.x, aby = (double)b.y - a.y, abz = (double)b.z - a.z ;
+    double acx = (double)c.x - a.x, acy = (double)c.y - a.y, acz = (double)c.z - a.z ;
+    double nx = aby*acz - abz*acy, ny = abz*acx - abx*acz, nz = abx*acy - aby*acx ;
+    double len = sqrt( nx*nx + ny*ny + nz*nz ) ;
+    if( len == 0.0 )
+    {
+      // degenerate, keep the float plane
+      faceNxd[f] = faceNx[f] ;  faceNyd[f] = faceNy[f] ;  faceNzd[f] = faceNz[f] ;  faceDd[f] = faceD[f] ;
+      return ;
+    }
+    nx /= len ;  ny /= len ;  nz /= len ;
+    double cx = ( (double)a.x + b.x + c.x ) / 3.0, cy = ( (double)a.y + b.y + c.y ) / 3.0, cz = ( (double)a.z + b.z + c.z ) / 3.0 ;
+    faceNxd[f] = nx ;  faceNyd[f] = ny ;  faceNzd[f] = nz ;
+    faceDd[f] = -( nx*cx + ny*cy + nz*cz ) ;
+  }
+  
+  // Kills face f, its outside set is appended to `orphans`.
+  void removeFace( int f, vector<int>& orphans ) {
+    faces[f].alive = 0 ;
+    orphans.insert( orphans.end(), faces[f].outside.begin(), faces[f].outside.end() ) ;
+    faces[f].outside.clear() ;
+    freeFaces.push_back( f ) ;
+  }
+  
+  // Links up the twins of the seed mesh by brute force. Only use on a handful of faces.
+  void linkTwins() {
+    for( int e = 0 ; e < he.size() ; e++ )
+    {
+      if( he[e].twin != -1 || !faces[e/3].alive )  skip ;
+      
+      // a---b in one face is b---a in the other.
+      int a = he[e].vert, b = he[nextHE(e)].vert ;
+      for( int e2 = 0 ; e2 < he.size() ; e2++ )
+        if( e2 != e && faces[e2/3].alive && he[e2].vert==b && he[nextHE(e2)].vert==a ) {
+          he[e].twin = e2 ;
+          he[e2].twin = e ;
+          break ;
+        }
+    }
   }
   
   // You have to find ALL faces that can "see" pt,
   // otherwise the polyhedron could become concave again.
   // expand the hull to include pt.
-  void expandToInclude( int pti ) 
+  void expandToInclude( int pti ) {
+    vector<int> orphans, newFaces ;
+    expandToInclude( pti, -1, orphans, newFaces ) ;
+  }
+  
+  // Same as above.  startFace is a face that pti can see (-1 to have me find one).
+  // The outside sets of the faces that got removed are handed back in `orphans`,
+  // and the faces that were created are listed in `newFaces`.
+  void expandToInclude( int pti, int startFace, vector<int>& orphans, vector<int>& newFaces )
   {
-    // 3 new tris imposed, then triIndex needs to be DELETED,
-    vector<int> facesThatPtCanSee ; // a single index that looks up into indices
-    // is only needed to specify a tri.
-    // the triangle is 3 verts, but the other 2 can be gotten by i+1, and i+2.
-    // we go through this backwards, so that in removal, the indices of indices marked for removal
-    // aren't going to be wrong AS WE'RE REMOVING THEM
-    for( int i = (int)indices.size()-3 ; i >= 0 ; i-=3 )
-    {
-      Plane plane( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]] ) ;
-      if( plane.distanceToPoint( verts[pti] ) >= 0.f )
-        facesThatPtCanSee.push_back( i ) ; // keep the index into the index array. the other 2 are implied by
-        // being the next 2 in the index array.
-    }
-        
-    // So, ALL THOSE FACES MUST BE REMOVED.
-    // the perimeter is the set of edges that only occur ONCE.
-    vector<IEdge> perimeter ; // the set of edges that see 
-    for( int i = 0 ; i < facesThatPtCanSee.size() ; i++ ) // Each ONE is a tri.
+    newFaces.clear() ;
+    if( startFace == -1 )
     {
-      int si = facesThatPtCanSee[i] ; /// starting index in indices for the tri.
-      int i1=indices[si+0], i2=indices[si+1], i3=indices[si+2] ;
-      //info( "Face starting at indices[%d], indices are (%d %d %d)", si, i1, i2, i3 ) ;
-      
-      // We have to analyze 3 edges at a time, but its not importnat they're distinctly named
-      IEdge edges[3] = { IEdge( i1,i2 ), IEdge( i2,i3 ), IEdge( i3,i1 ) } ;
-      
-      // If any of the edges ONLY OCCURS ONCE in the facesThatPtCanSee set, then it is a horizon edge.
-      for( int edgeNo = 0 ; edgeNo < 3 ; edgeNo++ )
+      // Start from the face pti is furthest in front of
+      float furthest = -HUGE ;
+      for( int i = 0 ; i < faces.size() ; i++ )
       {
-        IEdge &edge = edges[edgeNo] ; // This is the edge we're trying to see if is unique the selected set
-        bool isHorizonEdge = 1 ; // assume its unique
-        
-        // Next loop tries to eliminate the possibility that it is a horizon edge
-        // by checking for another occurrence of that same edge in the faceTahtPtCanSee group.
-        for( int j = 0 ; isHorizonEdge &&  // we still belive it could be a horizon edge
-             j < facesThatPtCanSee.size() ; j++ )
-        {
-          if( j==i ) skip ;  // Don't check the triangle i came from, to see if there is an edge repeat.
-          
-          // at each face in the faces that pt can see set, we get the 3 edges of the face in jedges.
-          int jsi = facesThatPtCanSee[j] ;
-          int j1=indices[jsi+0], j2=indices[jsi+1], j3=indices[jsi+2] ;
-          
-          // Now see if the edge we're checking is the same as any of the 3 edges of this face.
-          IEdge jedges[3] = { IEdge( j1,j2 ), IEdge( j2,j3 ), IEdge( j3,j1 ) } ; // 3 edges of the face
-          for( int jEdgeNo=0 ; jEdgeNo < 3 ; jEdgeNo++ )
-          {
-            if( edge.same(jedges[jEdgeNo]) ) {
-              isHorizonEdge=0; // its the same. 
-              //info( "Edge %d %d same as %d %d", edge.a,edge.b, jedges[jEdgeNo].a,jedges[jEdgeNo].b ) ;
-              break ;
-            }
-          }
+        if( !faces[i].alive )  skip ;
+        float dist = faceDistance( i, verts[pti] ) ;
+        if( dist > furthest && ( !exactPredicates || faceSees( i, verts[pti] ) ) ) {
+          furthest = dist ;
+          startFace = i ;
         }
-        
-        if( isHorizonEdge )  perimeter.push_back( edge ) ;
       }
+      if( startFace == -1 )  return ; // pti can't see any face, nothing to do.
+      if( !exactPredicates && furthest < 0.f )  return ;
     }
     
+    // Flood out from startFace over faces that can see pti.
+    // the horizon is where the flood stops.
+    visitStamp++ ;
+    vector<int> facesThatPtCanSee, horizon ;
+    findHorizon( pti, -1, startFace, facesThatPtCanSee, horizon ) ;
+    
+    // Save the horizon edges as vertex pairs + the twin on the far (hidden) side,
+    // since the visible faces' slots get recycled below.
+    struct HorizonEdge { int a, b, twin ; } ;
+    vector<HorizonEdge> perimeter ;
+    for( int i = 0 ; i < horizon.size() ; i++ )
+    {
+      HorizonEdge edge = { he[horizon[i]].vert, he[nextHE(horizon[i])].vert, he[horizon[i]].twin } ;
+      perimeter.push_back( edge ) ;
+    }
+    
+    // So, ALL THOSE FACES MUST BE REMOVED.
+    for( int i = 0 ; i < facesThatPtCanSee.size() ; i++ )
+      removeFace( facesThatPtCanSee[i], orphans ) ;
     
-    //info( "pti could see %d faces, perimeter has %d edges", facesThatPtCanSee.size(), perimeter.size() ) ;
     // we then walk the PERIMETER
-    // since the tris were all wound ccw, yo actuall just wind tris in ANY ORDER,
-    // fan them out from (newpoint, edge.a, edge.b ) ;
+    // fan out new tris from (newpoint, edge.a, edge.b ).  edge a---b keeps the
+    // winding it had in the removed face, so its twin is still the hidden face's b---a.
     for( int i = 0 ; i < perimeter.size() ; i++ )
-      addTri( pti, perimeter[i].a, perimeter[i].b ) ;
+    {
+      int f = addTri( pti, perimeter[i].a, perimeter[i].b ) ;
+      if( f == -1 )  skip ;
+      he[3*f+1].twin = perimeter[i].twin ;
+      if( perimeter[i].twin != -1 )
+        he[perimeter[i].twin].twin = 3*f+1 ;
+      newFaces.push_back( f ) ;
+    }
     
-    // REMOVE ALL OF THE OLD FACES
-    // can either delete or just _don't copy_
-    //vector<int> newIndices ;
-    for( int i = 0 ; i < facesThatPtCanSee.size() ; i++ ) // Each ONE is a tri.
+    // Stitch the new faces to each other: b---pti in one is pti---b in the next.
+    // The horizon comes out of findHorizon in order, so the match is almost always the next face.
+    for( int i = 0 ; i < newFaces.size() ; i++ )
     {
-      // delete __3__ entries from indices starting from facesThatPtCanSee[i]
-      indices.erase( indices.begin() + facesThatPtCanSee[i],
-                     indices.begin() + facesThatPtCanSee[i]+3 ) ; // say deletes 9,10 and 11
+      int e = 3*newFaces[i]+2, b = he[e].vert ;
+      for( int j = 1 ; j <= newFaces.size() ; j++ )
+      {
+        int o = 3*newFaces[ (i+j) % newFaces.size() ] ;
+        if( he[o+1].vert == b ) {
+          he[e].twin = o ;
+          he[o].twin = e ;
+          break ;
+        }
+      }
     }
   }
   
+  // DFS over faces that can see pti, starting at face f (entered through its half-edge crossedEdge,
+  // or -1 for the first face).  Visible faces go in `visible`, and the half-edges of visible faces
+  // whose neighbour can't see pti go in `horizon`, in ccw order around the hole.
+  // The DFS keeps its own stack: a far pt can see nearly every face of a big hull, and recursing
+  // once per visible face would run out of thread stack.
+  void findHorizon( int pti, int crossedEdge, int f, vector<int>& visible, vector<int>& horizon )
+  {
+    // A face being walked: the half-edge to look across next, and how many of its 3 are done
+    struct Frame { int f, e, k ; } ;
+    vector<Frame> stack ;
+    auto enter = [&]( int face, int entry ) {
+      faces[face].visit = visitStamp ;
+      visible.push_back( face ) ;
+      Frame frame = { face, (entry == -1) ? 3*face : nextHE( entry ), 0 } ;
+      stack.push_back( frame ) ;
+    } ;
+    
+    enter( f, crossedEdge ) ;
+    while( stack.size() )
+    {
+      Frame& top = stack.back() ;
+      if( top.k == 3 ) {
+        stack.pop_back() ;
+        skip ;
+      }
+      int e = top.e ;
+      top.e = nextHE( e ) ;
+      top.k++ ;
+      
+      int twin = he[e].twin ;
+      if( twin == -1 ) { horizon.push_back( e ) ; skip ; } // open mesh, treat it as horizon
+      
+      int nf = twin/3 ;
+      if( faces[nf].visit == visitStamp )  skip ; // already in the visible set
+      
+      bool sees = exactPredicates ? faceSees( nf, verts[pti] ) : faceDistance( nf, verts[pti] ) >= 0.f ;
+      if( sees )
+        enter( nf, twin ) ; // (top is stale after this)
+      else
+        horizon.push_back( e ) ;
+    }
+  }
+  
+  void clearFinal() {
+    finalPts.clear() ;  finalNormals.clear() ;  finalTris.clear() ;  finalFaces.clear() ;
+    finalPtVerts.clear() ;  finalTriNormals.clear() ;  finalNormalRefs.clear() ;
+    finalPolys.clear() ;  facePoly.clear() ;  finalEdges.clear() ;  finalEdgeDirs.clear() ;
+    ptNeighbourStart.clear() ;  ptNeighbours.clear() ;
+  }
+  
   void getFinalPts()
   {
+    clearFinal() ;
+    
+    // Flatten the live faces of the mesh into the index buffer
+    indices.clear() ;
+    for( int f = 0 ; f < faces.size() ; f++ )
+    {
+      if( !faces[f].alive )  skip ;
+      for( int k = 0 ; k < 3 ; k++ )
+        indices.push_back( faceVert( f, k ) ) ;
+    }
+    
     // Quickly filter the nonunique indices
     set<int> uniqueIndices( indices.begin(), indices.end() ) ;
     for( set<int>::iterator iter = uniqueIndices.begin() ; iter != uniqueIndices.end() ; ++iter )
+    {
       finalPts.push_back( verts[*iter] ) ;
+      finalPtVerts.push_back( *iter ) ;
+    }
+    
+    mergeCoplanarFaces() ;
+    findFinalEdges() ;
+    
+    for( int f = 0 ; f < faces.size() ; f++ )
+      if( faces[f].alive )
+        addFinalTri( f ) ;
+    
+    copyFinalToTransformed() ;
+  }
+  
+  // Appends face f to finalTris, and its normal to finalNormals if we don't have one like it.
+  // The tris of a polygon all share the polygon's normal, so only its first tri has to look.
+  void addFinalTri( int f )
+  {
+    // Now keep the normals, for SAT tests.
+    Triangle tri( verts[faceVert(f,0)], verts[faceVert(f,1)], verts[faceVert(f,2)] ) ;
+    finalTris.push_back( tri ) ;
+    finalFaces.push_back( f ) ;
+    
+    HullPolygon* poly = ( f < facePoly.size() && facePoly[f] != -1 ) ? &finalPolys[ facePoly[f] ] : 0 ;
+    Vector3f normal = poly ? poly->plane.normal : tri.plane.normal ;
+    int had = poly ? poly->normal : -1 ;
+    
+    // If we don't already have a normal like that,
+    for( int j = 0 ; had==-1 && j < finalNormals.size(); j++ )
+      // For SAT testing, lack of overlap in direction `normal` will
+      // also be lack of overlap in direction `-normal`, no need to check both.
+      if( finalNormals[j].isNear(  normal ) ||
+          finalNormals[j].isNear( -normal ) ) {
+        had=j;
+        break;
+      }
+    if( had==-1 ) {
+      had = (int)finalNormals.size() ;
+      finalNormals.push_back( normal ) ;
+      finalNormalRefs.push_back( 0 ) ;
+    }
+    if( poly )  poly->normal = had ;
+    finalTriNormals.push_back( had ) ;
+    finalNormalRefs[had]++ ;
+  }
+  
+  // Floods each live face out over its neighbours that lie in the same plane (to within a
+  // hair, relative to the hull's size), and makes each flood a HullPolygon in finalPolys.
+  // Faces are only compared to the face the flood started from, so a slightly curved surface
+  // doesn't creep into 1 big polygon.  The coplanar part of a convex hull is convex,
+  // so walking the flood's outer edges gives a convex polygon.  Needs finalPtVerts.
+  void mergeCoplanarFaces()
+  {
+    finalPolys.clear() ;
+    facePoly.assign( faces.size(), -1 ) ;
     
-    for( int i = 0 ; i < indices.size() ; i+=3 )
+    vector<int> finalIndex( verts.size(), -1 ) ; // verts index -> finalPts index
+    for( int i = 0 ; i < finalPtVerts.size() ; i++ )
+      finalIndex[ finalPtVerts[i] ] = i ;
+    
+    const float CoplanarCos = 0.99999f ;
+    float planeEps = max( EPS_MIN, 1e-5f * (aabb.max - aabb.min).len() ) ;
+    
+    vector<int> stack, region ;
+    unordered_map<int,int> boundaryNext ; // vert -> next vert ccw around the polygon
+    for( int f = 0 ; f < faces.size() ; f++ )
     {
-      // Now keep the normals, for SAT tests.
-      Triangle tri( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]] ) ;
-      finalTris.push_back( tri ) ;
+      if( !faces[f].alive || facePoly[f] != -1 )  skip ;
       
-      // If we don't already have a normal like that,
-      bool had=0;
-      for( int j = 0 ; j < finalNormals.size(); j++ )
-        // For SAT testing, lack of overlap in direction `normal` will
-        // also be lack of overlap in direction `-normal`, no need to check both.
-        if( finalNormals[j].isNear(  tri.plane.normal ) ||
-            finalNormals[j].isNear( -tri.plane.normal ) ) {
-          had=1;
-          break;
+      int p = (int)finalPolys.size() ;
+      Plane seedPlane = facePlane( f ) ;
+      facePoly[f] = p ;
+      stack.assign( 1, f ) ;
+      region.clear() ;
+      while( stack.size() )
+      {
+        int g = stack.back() ;
+        stack.pop_back() ;
+        region.push_back( g ) ;
+        for( int k = 0 ; k < 3 ; k++ )
+        {
+          int n = faceNeighbour( g, k ) ;
+          if( n == -1 || facePoly[n] != -1 )  skip ;
+          if( facePlane( n ).normal.dot( seedPlane.normal ) < CoplanarCos )  skip ;
+          bool flat = 1 ;
+          for( int j = 0 ; flat && j < 3 ; j++ )
+            flat = fabsf( seedPlane.distanceToPoint( verts[faceVert(n,j)] ) ) <= planeEps ;
+          if( !flat )  skip ;
+          facePoly[n] = p ;
+          stack.push_back( n ) ;
+        }
+      }
+      
+      // The polygon's plane is the area weighted normal of its tris, through their centroid
+      Vector3f normalSum, centroid ;
+      boundaryNext.clear() ;
+      int start = -1 ;
+      for( int i = 0 ; i < region.size() ; i++ )
+      {
+        int g = region[i] ;
+        const Vector3f &a = verts[faceVert(g,0)], &b = verts[faceVert(g,1)], &c = verts[faceVert(g,2)] ;
+        normalSum += ( b - a ).cross( c - a ) ;
+        centroid += ( a + b + c ) / 3.f ;
+        for( int k = 0 ; k < 3 ; k++ )
+        {
+          int n = faceNeighbour( g, k ) ;
+          if( n != -1 && facePoly[n] == p )  skip ; // inside edge
+          boundaryNext[ faceVert(g,k) ] = faceVert( g, (k+1)%3 ) ;
+          start = faceVert( g, k ) ;
         }
-      if(!had)
-        finalNormals.push_back( tri.plane.normal ) ;
+      }
+      
+      HullPolygon poly ;
+      poly.plane = Plane( normalSum.normalizedCopy(), centroid / (float)region.size() ) ;
+      for( int v = start, guard = 0 ; guard < boundaryNext.size() ; guard++ )
+      {
+        poly.pts.push_back( finalIndex[v] ) ;
+        v = boundaryNext[v] ;
+        if( v == start )  break ;
+      }
+      finalPolys.push_back( poly ) ;
     }
+  }
+  
+  // Every mesh edge that has a different polygon on each side is a hull edge.
+  // Every mesh edge at all joins 2 pts in ptNeighbours.
+  // Needs facePoly (mergeCoplanarFaces).
+  void findFinalEdges()
+  {
+    finalEdges.clear() ;
+    finalEdgeDirs.clear() ;
     
+    vector<int> finalIndex( verts.size(), -1 ) ; // verts index -> finalPts index
+    for( int i = 0 ; i < finalPtVerts.size() ; i++ )
+      finalIndex[ finalPtVerts[i] ] = i ;
+    vector< vector<int> > neighbours( finalPts.size() ) ;
     
+    for( int f = 0 ; f < faces.size() ; f++ )
+    {
+      if( !faces[f].alive )  skip ;
+      for( int k = 0 ; k < 3 ; k++ )
+      {
+        int e = 3*f + k, twin = he[e].twin ;
+        if( twin == -1 || twin < e )  skip ; // each edge once, from its lower half-edge
+        
+        HullEdge edge ;
+        edge.a = finalIndex[ faceVert( f, k ) ] ;
+        edge.b = finalIndex[ faceVert( f, (k+1)%3 ) ] ;
+        neighbours[ edge.a ].push_back( edge.b ) ;
+        neighbours[ edge.b ].push_back( edge.a ) ;
+        
+        edge.poly[0] = facePoly[f] ;
+        edge.poly[1] = facePoly[ twin/3 ] ;
+        if( edge.poly[0] == edge.poly[1] )  skip ; // a diagonal inside a polygon
+        
+        // If we don't already have a direction like that (either way along it)
+        Vector3f dir = ( finalPts[edge.b] - finalPts[edge.a] ).normalizedCopy() ;
+        edge.dir = -1 ;
+        for( int j = 0 ; j < finalEdgeDirs.size() ; j++ )
+          if( finalEdgeDirs[j].isNear( dir ) || finalEdgeDirs[j].isNear( -dir ) ) {
+            edge.dir = j ;
+            break ;
+          }
+        if( edge.dir == -1 ) {
+          edge.dir = (int)finalEdgeDirs.size() ;
+          finalEdgeDirs.push_back( dir ) ;
+        }
+        finalEdges.push_back( edge ) ;
+      }
+    }
     
+    ptNeighbourStart.clear() ;
+    ptNeighbours.clear() ;
+    for( int i = 0 ; i < neighbours.size() ; i++ )
+    {
+      ptNeighbourStart.push_back( (int)ptNeighbours.size() ) ;
+      ptNeighbours.insert( ptNeighbours.end(), neighbours[i].begin(), neighbours[i].end() ) ;
+    }
+    ptNeighbourStart.push_back( (int)ptNeighbours.size() ) ;
+  }
+  
+  void copyFinalToTransformed()
+  {
     // identity-transform save copies of finalNormals etc.
     transformedPts = finalPts ;
+    transformedTris.clear() ;
     for( Triangle& tri : finalTris )
       transformedTris.push_back( tri ) ;
     transformedNormals = finalNormals ;
+    transformedPlanes.clear() ;
+    for( int i = 0 ; i < finalPolys.size() ; i++ )
+      transformedPlanes.push_back( finalPolys[i].plane ) ;
+    transformedEdgeDirs = finalEdgeDirs ;
+    syncTransformedSoA() ;
+    transformedMatrix = Matrix4f() ;
+    staleArrays = 0 ;
+    if( !localSpace ) { // back where it was built (in local space, pose still says where it is)
+      rigid = RigidTransform() ;
+      isRigid = 1 ;
+    }
+  }
+  
+  void syncTransformedSoA() const {
+    transformedSoA.set( transformedPts ) ;
+  }
+  
+  // Polygon i's transformed plane, once its normal is known.  Has to go after transformedPts are done.
+  inline void setTransformedPlane( int i, const Vector3f& normal ) {
+    transformedPlanes[i] = Plane( normal, transformedPts[ finalPolys[i].pts[0] ] ) ;
+  }
+  
+  // A lazy move: every array is behind transformedMatrix now
+  void markStale() {
+    staleArrays = AllTransformed ;
+    lazyMoves++ ;
+  }
+  
+  // Redoes each stale array in `arrays` from its final* one, by transformedMatrix.
+  // Each comes out the same as transform( transformedMatrix ) would make it.
+  void materializeStale( int arrays ) const {
+    int todo = arrays & staleArrays ;
+    if( todo & TransformedSoA )  todo |= TransformedPts & staleArrays ; // made from the pts
+    const Matrix4f& m = transformedMatrix ;
+    
+    if( todo & TransformedPts )
+      for( int i = 0 ; i < finalPts.size() ; i++ )
+        transformedPts[i] = m * finalPts[i] ;
+    if( todo & TransformedSoA )
+      syncTransformedSoA() ;
+    if( todo & TransformedNormals )
+      for( int i = 0 ; i < finalNormals.size() ; i++ )
+        transformedNormals[i] = m.upper3x3( finalNormals[i] ) ;
+    if( todo & TransformedTris )
+      for( int i = 0 ; i < finalTris.size() ; i++ )
+        transformedTris[i] = m * finalTris[i] ;
+    if( todo & TransformedPlanes ) // from the final pts, so it doesn't need transformedPts
+      for( int i = 0 ; i < finalPolys.size() ; i++ )
+        transformedPlanes[i] = Plane( m.upper3x3( finalPolys[i].plane.normal ), m * finalPts[ finalPolys[i].pts[0] ] ) ;
+    if( todo & TransformedEdgeDirs )
+      for( int i = 0 ; i < finalEdgeDirs.size() ; i++ )
+        transformedEdgeDirs[i] = m.upper3x3( finalEdgeDirs[i] ) ;
+    
+    for( int bit = 1 ; bit < AllTransformed ; bit <<= 1 )
+      if( todo & bit )  materializations++ ;
+    staleArrays &= ~todo ;
   }
   
   void expandToContainAllPts()
@@ -535,19 +1845,103 @@ private:
     getFinalPts() ;    
   }
 
+  // QuickHull with conflict lists.  Each remaining pt is assigned to ONE face it is
+  // outside of.  When a face is removed, only its pts are reassigned, and only among the
+  // faces the new apex just created.  The next apex is always the furthest pt
+  // of some face's own conflict list, so we never rescan all pts vs all faces.
+  void expandToContainAllPtsConflict()
+  {
+    // Initial assignment against the seed hull.  Pts not outside any face are inside, gone.
+    vector<int> seedFaces ;
+    for( int i = 0 ; i < faces.size() ; i++ )
+      if( faces[i].alive )
+        seedFaces.push_back( i ) ;
+    assignToConflictLists( remIndices, seedFaces ) ;
+    remIndices.clear() ;
+    
+    expandConflictFaces() ;
+    getFinalPts() ;
+  }
+  
+  // Keeps adding the furthest pt of some face's outside set until every outside set is empty.
+  void expandConflictFaces()
+  {
+    vector<int> orphans, newFaces ;
+    int ti ;
+    while( (ti = nextConflictFace()) != -1 )
+    {
+      // 1) the apex is the furthest pt in that face's outside set
+      vector<int>& outside = faces[ti].outside ;
+      int fi = 0 ;
+      float furthestDistance = -HUGE ;
+      for( int i = 0 ; i < outside.size() ; i++ )
+      {
+        float dist = faceDistance( ti, verts[outside[i]] ) ;
+        if( dist > furthestDistance ) {
+          fi = i ;
+          furthestDistance = dist ;
+        }
+      }
+      
+      int apex = outside[fi] ;
+      outside.erase( outside.begin() + fi ) ; // the apex goes ON the hull, not in any outside set
+      
+      // 2) poke the hull.  pts of the removed faces come back as orphans,
+      orphans.clear() ;
+      expandToInclude( apex, ti, orphans, newFaces ) ;
+      
+      // 3) and only the new faces can take them.
+      assignToConflictLists( orphans, newFaces ) ;
+    }
+  }
+  
+  // Puts each pt in `pts` into the conflict list of the face (of `candidateFaces`)
+  // that it is furthest outside of.  Pts within `tolerance` of all those faces are dropped.
+  void assignToConflictLists( const vector<int>& pts, const vector<int>& candidateFaces )
+  {
+    for( int i = 0 ; i < pts.size() ; i++ )
+    {
+      int bestFace = -1 ;
+      float bestDist = exactPredicates ? -HUGE : tolerance ;
+      for( int j = 0 ; j < candidateFaces.size() ; j++ )
+      {
+        float dist = faceDistance( candidateFaces[j], verts[pts[i]] ) ;
+        if( dist > bestDist && ( !exactPredicates || faceSees( candidateFaces[j], verts[pts[i]] ) ) ) {
+          bestDist = dist ;
+          bestFace = candidateFaces[j] ;
+        }
+      }
+      if( bestFace == -1 )  skip ;
+      
+      if( faces[bestFace].outside.empty() )
+        pendingFaces.push_back( bestFace ) ;
+      faces[bestFace].outside.push_back( pts[i] ) ;
+    }
+  }
+  
+  // A face with a non-empty outside set, or -1 when done.
+  int nextConflictFace() {
+    while( pendingFaces.size() )
+    {
+      int f = pendingFaces.back() ;
+      if( faces[f].alive && faces[f].outside.size() )
+        return f ; // stays on the stack, it gets removed when its apex is added
+      pendingFaces.pop_back() ;
+    }
+    return -1 ;
+  }
+
   // Tri normals point OUTSIDE the hull, so,
   // if you are on the + side of any tri you are NOT INSIDE
   // Because we're trying to simplify the hull, EXTREMELY CLOSE POINTS
   // are considered OUTSIDE
   bool insideIB( int pti ) const {
-    for( int i = 0 ; i < (int)indices.size() ; i+=3 )
+    for( int i = 0 ; i < faces.size() ; i++ )
     {
-      // Reconstructing the plane IS expensive, but this code isn't optimized there.
-      Plane plane( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]] ) ;
-      
+      if( !faces[i].alive )  skip ;
       // if the dist below is -, it means the pt is INSIDE according to this face.
       // if it is +, it means it is DEFINITELY OUTSIDE THE SHAPE since it is outside at least 1 face.
-      if( plane.distanceToPoint( verts[pti] ) > tolerance ) // ITS NOT INSIDE.  The larger tolerance is, the more willing
+      if( faceDistance( i, verts[pti] ) > tolerance ) // ITS NOT INSIDE.  The larger tolerance is, the more willing
       // I am to say "Ok, you're still inside" even though you are slightly out of line / slightly outside.
       // this eps is important for points you just added to the hull.
         return 0 ;
@@ -572,19 +1966,18 @@ private:
   
   // Get you the distance to the CLOSEST triangle in the hull.
   // The point is outside already, now, get me the SMALLEST distance,
-  // This operates on the INDEX BUFFER, ie it is to be used
+  // This operates on the MESH, ie it is to be used
   // DURING HULL CONSTRUCTION, before finalTris is complete.
   // So you shouldn't use this outside this class.  It is marked IB
-  // because it uses the index buffer, constructing Triangle objects for EACH TRI.
+  // because it used to use the index buffer.  It uses the faceTris precomputed at face creation.
   // Because of the possibility of face removal tris aren't kept (they could be)
   float distanceToClosestTriIB( int pti, Vector3f& closestPtOnTri ) const {
     float minDist=HUGE ;
-    for( int i = 0 ; i < indices.size() ; i+=3 )
+    for( int i = 0 ; i < faces.size() ; i++ )
     {
-      Triangle tri( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]] ) ;
-      
+      if( !faces[i].alive )  skip ;
       Vector3f ptOnTri ;
-      float dist = tri.distanceToPoint( verts[pti], ptOnTri ) ;
+      float dist = faceTris[i].distanceToPoint( verts[pti], ptOnTri ) ;
       if( dist < minDist ) {
         minDist=dist;
         closestPtOnTri = ptOnTri ;
@@ -605,8 +1998,59 @@ private:
   ///////////////////////////
   // INTERSECTION ROUTINES //
 public:
+  // Turning lazy transforms off brings every transformed* array up to date first.
+  void setLazyTransforms( bool on ) {
+    if( !on )  materialize( AllTransformed ) ;
+    lazyTransforms = on ;
+  }
+  
+  // Brings the transformed* arrays in `arrays` (TransformedArray bits) up to date, if lazy
+  // transforms left them behind.  Each query does it for just the arrays it reads, so if you
+  // read transformed* yourself with lazy transforms on, call it first.
+  // It writes the cache, so a lazy hull that was moved can't be queried from 2 threads at once:
+  // call materialize( AllTransformed ) first (then no query writes anything).
+  void materialize( int arrays ) const {
+    if( arrays & staleArrays )
+      materializeStale( arrays ) ;
+  }
+  
+  // Turning local space on puts the transformed* arrays back where the hull was built, and
+  // where I was (rigid, or else transformedMatrix) goes in pose instead, so the body doesn't move.
+  // (Any scale or shear in transformedMatrix is lost, like in transform.)  Turning it off
+  // transforms the arrays out to where pose had me.
+  void setLocalSpace( bool on ) {
+    if( on == localSpace )  return ;
+    localSpace = on ;
+    if( on ) {
+      if( isRigid )  pose = HullPose( rigid.rot.toMatrix3f(), rigid.pos ) ;
+      else  pose = HullPose( transformedMatrix.getRotation(), transformedMatrix.getTranslation() ) ;
+      copyFinalToTransformed() ;
+      return ;
+    }
+    if( isRigid )  transform( RigidTransform( rigid ) ) ;
+    else if( pose.moved )  transform( Matrix4f( pose.rot, pose.pos ) ) ;
+    pose = HullPose() ;
+  }
+  
+  // The move from o's space (the one its transformed* arrays are in) to mine.
+  HullPose poseFrom( const Hull& o ) const {
+    if( !pose.moved && !o.pose.moved )  return HullPose() ;
+    return HullPose( pose.rotT*o.pose.rot, pose.rotT*( o.pose.pos - pose.pos ) ) ;
+  }
+  
   // The default is to re-transform from the original point set.
   void transform( const Matrix4f& matrix ) {
+    isRigid = 0 ;
+    if( localSpace ) {
+      pose = HullPose( matrix.getRotation(), matrix.getTranslation() ) ;
+      return ;
+    }
+    transformedMatrix = matrix ;
+    if( lazyTransforms ) {
+      markStale() ;
+      return ;
+    }
+    
     // The containers are already the right size (in getFinalPts).
     for( int i = 0 ; i < finalTris.size() ; i++ )
       transformedTris[i] = matrix * finalTris[i] ;
@@ -616,10 +2060,29 @@ public:
       
     for( int i = 0 ; i < finalPts.size() ; i++ )
       transformedPts[i] = matrix * finalPts[i] ;
+    
+    for( int i = 0 ; i < finalPolys.size() ; i++ )
+      setTransformedPlane( i, matrix.upper3x3( finalPolys[i].plane.normal ) ) ;
+    
+    for( int i = 0 ; i < finalEdgeDirs.size() ; i++ )
+      transformedEdgeDirs[i] = matrix.upper3x3( finalEdgeDirs[i] ) ;
+    
+    syncTransformedSoA() ;
   }
   
   // This transforms the transformed pts from where the transformed last were,
   void transformTransformed( const Matrix4f& matrix ) {
+    isRigid = 0 ;
+    if( localSpace ) {
+      pose = pose.then( matrix.getRotation(), matrix.getTranslation() ) ;
+      return ;
+    }
+    transformedMatrix = matrix * transformedMatrix ;
+    if( lazyTransforms ) {
+      markStale() ;
+      return ;
+    }
+    
     for( PrecomputedTriangle &tri : transformedTris )
       tri = matrix * tri ;
       
@@ -628,9 +2091,27 @@ public:
       
     for( Vector3f& pt : transformedPts )
       pt = matrix * pt ;
+    
+    for( int i = 0 ; i < transformedPlanes.size() ; i++ )
+      setTransformedPlane( i, matrix.upper3x3( transformedPlanes[i].normal ) ) ;
+    
+    for( Vector3f& dir : transformedEdgeDirs )
+      dir = matrix.upper3x3( dir ) ;
+    
+    syncTransformedSoA() ;
   }
   
   void transformTransformed( const Matrix3f& rot ) {
+    isRigid = 0 ;
+    if( localSpace ) {
+      pose = pose.then( rot, Vector3f() ) ;
+      return ;
+    }
+    transformedMatrix = Matrix4f( rot ) * transformedMatrix ;
+    if( lazyTransforms ) {
+      markStale() ;
+      return ;
+    }
     // The containers are already the right size (in getFinalPts).
     for( PrecomputedTriangle &tri : transformedTris )
       tri = rot * tri ;
@@ -638,19 +2119,48 @@ public:
       pt = rot*pt ;
     for( Vector3f& pt : transformedPts )
       pt = rot*pt ;
+    for( int i = 0 ; i < transformedPlanes.size() ; i++ )
+      setTransformedPlane( i, rot*transformedPlanes[i].normal ) ;
+    for( Vector3f& dir : transformedEdgeDirs )
+      dir = rot*dir ;
+    syncTransformedSoA() ;
   }
   
   void translateTransformed( const Vector3f& trans ) {
+    rigid.pos += trans ; // a translation is rigid
+    if( localSpace ) {
+      pose = pose.then( Matrix3f(), trans ) ;
+      return ;
+    }
+    transformedMatrix = Matrix4f::Translation( trans ) * transformedMatrix ;
+    if( lazyTransforms ) {
+      markStale() ;
+      return ;
+    }
     for( PrecomputedTriangle &tri : transformedTris )
       tri = tri + trans ;
     for( Vector3f& pt : transformedPts )
       pt += trans ;
+    for( int i = 0 ; i < transformedPlanes.size() ; i++ )
+      setTransformedPlane( i, transformedPlanes[i].normal ) ;
+    syncTransformedSoA() ;
   }
   
   // Used by drifters, who "untranslate" each vertex so
   // the hull is back at the origin, rotate the hull, then translate it back out again.
   void untranslateRotateTranslate( const Vector3f& untrans, const Matrix3f& rot )
   {
+    isRigid = 0 ;
+    if( localSpace ) {
+      pose = pose.then( rot, untrans - rot*untrans ) ;
+      return ;
+    }
+    transformedMatrix = Matrix4f( rot, untrans - rot*untrans ) * transformedMatrix ;
+    if( lazyTransforms ) {
+      markStale() ;
+      return ;
+    }
+    
     for( Vector3f& pt : transformedPts )
     {
       pt -= untrans ;    // 1. untranslate
@@ -670,17 +2180,71 @@ public:
       
       tri = PrecomputedTriangle( pa, pb, pc ) ;
     }
+    
+    for( int i = 0 ; i < transformedPlanes.size() ; i++ )
+      setTransformedPlane( i, rot*transformedPlanes[i].normal ) ;
+    for( Vector3f& dir : transformedEdgeDirs )
+      dir = rot*dir ;
+    syncTransformedSoA() ;
+  }
+  
+  // RIGID MOVES.  The same as the Matrix4f ones, but the hull keeps where it is in `rigid`
+  // (the quaternion renormalized on every move), so it can't end up scaled or sheared.
+  
+  // Re-transforms from the original point set, to xf
+  void transform( const RigidTransform& xf ) {
+    rigid = xf ;
+    rigid.rot.normalize() ;
+    isRigid = 1 ;
+    Matrix3f rot = rigid.rot.toMatrix3f() ;
+    if( localSpace ) {
+      pose = HullPose( rot, rigid.pos ) ;
+      return ;
+    }
+    transformedMatrix = Matrix4f( rot, rigid.pos ) ;
+    if( lazyTransforms ) {
+      markStale() ;
+      return ;
+    }
+    
+    rigid.apply( finalPts.data(), transformedPts.data(), (int)finalPts.size() ) ;
+    rigid.applyDir( finalNormals.data(), transformedNormals.data(), (int)finalNormals.size() ) ;
+    rigid.applyDir( finalEdgeDirs.data(), transformedEdgeDirs.data(), (int)finalEdgeDirs.size() ) ;
+    for( int i = 0 ; i < finalTris.size() ; i++ )
+    {
+      const Triangle& tri = finalTris[i] ;
+      transformedTris[i] = PrecomputedTriangle( rot*tri.a + rigid.pos, rot*tri.b + rigid.pos, rot*tri.c + rigid.pos ) ;
+    }
+    for( int i = 0 ; i < finalPolys.size() ; i++ )
+      setTransformedPlane( i, rot*finalPolys[i].plane.normal ) ;
+    syncTransformedSoA() ;
+  }
+  
+  // Moves the hull by xf from where it is.  While isRigid, that's a transform from the original
+  // point set to xf*rigid: no error builds up in the transformed* arrays however many times you call it.
+  void transformTransformed( const RigidTransform& xf ) {
+    if( isRigid )  transform( xf * rigid ) ;
+    else  transformTransformed( xf.toMatrix4f() ) ;
+  }
+  
+  // untranslateRotateTranslate, by a quaternion
+  void untranslateRotateTranslate( const Vector3f& untrans, const Quaternion& rot ) {
+    transformTransformed( RigidTransform( rot, untrans - rot*untrans ) ) ;
   }
   
   // You can ask me if some random pt is inside the hull or not after hull formation completed
-  bool inside( const Vector3f& pt ) const {
-    for( int i = 0 ; i < transformedTris.size() ; i++ )
-      if( transformedTris[i].plane.distanceToPoint( pt ) > tolerance )
+  bool inside( const Vector3f& worldPt ) const {
+    materialize( TransformedPlanes ) ;
+    Vector3f pt = pose.ptBack( worldPt ) ;
+    for( int i = 0 ; i < transformedPlanes.size() ; i++ )
+      if( transformedPlanes[i].distanceToPoint( pt ) > tolerance )
         return 0 ;
     return 1 ; // you are inside all the planes
   }
 
-  float distanceToClosestPointOnHull( const Vector3f& pt, Vector3f& closestPtOnHull ) const {
+  float distanceToClosestPointOnHull( const Vector3f& worldPt, Vector3f& closestPtOnHull ) const {
+    materialize( TransformedTris ) ;
+    Vector3f pt = pose.ptBack( worldPt ) ;
     float minDist=HUGE ;
     for( int i = 0 ; i < transformedTris.size() ; i++ )
     {
@@ -691,6 +2255,7 @@ public:
         closestPtOnHull = ptOnTri ;
       }
     }
+    closestPtOnHull = pose.pt( closestPtOnHull ) ;
     return minDist ;
   }
 
@@ -700,11 +2265,21 @@ public:
     return closestPtOnHull ;
   }
   
-  bool intersectsTri( const PrecomputedTriangle& tri ) const {
+  // tri brought over into my space.  It only has to be rebuilt (in movedTri) when I'm in local space.
+  const PrecomputedTriangle& toMySpace( const PrecomputedTriangle& tri, PrecomputedTriangle& movedTri ) const {
+    if( !pose.moved )  return tri ;
+    movedTri = PrecomputedTriangle( pose.ptBack( tri.a ), pose.ptBack( tri.b ), pose.ptBack( tri.c ) ) ;
+    return movedTri ;
+  }
+  
+  bool intersectsTri( const PrecomputedTriangle& worldTri ) const {
+    materialize( TransformedSoA | TransformedNormals ) ;
+    PrecomputedTriangle movedTri ;
+    const PrecomputedTriangle& tri = toMySpace( worldTri, movedTri ) ;
     float meMin, meMax, oMin, oMax ;
     
     // Start with tri normal.
-    SATtest( tri.plane.normal, transformedPts, meMin, meMax ) ;
+    SATtest( tri.plane.normal, transformedSoA, meMin, meMax ) ;
     SATtest( tri.plane.normal, tri.a, oMin, oMax ) ; //Only need to test 1 pt from tri, since all 3 will collapse to same pt.
     
     if( !overlaps( meMin, meMax, oMin, oMax ) ) {
@@ -718,7 +2293,7 @@ public:
     //triPts.push_back( tri.a ) ;  triPts.push_back( tri.b ) ;  triPts.push_back( tri.c ) ;
     for( int i = 0 ; i < transformedNormals.size() ; i++ )
     {
-      SATtest( transformedNormals[i], transformedPts, meMin, meMax ) ;
+      SATtest( transformedNormals[i], transformedSoA, meMin, meMax ) ;
       SATtest( transformedNormals[i], &tri.a, 3, oMin, oMax ) ;
       
       if( !overlaps( meMin, meMax, oMin, oMax ) ) {
@@ -738,7 +2313,7 @@ public:
         if( axis.allzero() ) skip ;
         axis.normalize() ;
         
-        SATtest( axis, transformedPts, meMin, meMax ) ;
+        SATtest( axis, transformedSoA, meMin, meMax ) ;
         SATtest( axis, &tri.a, 3, oMin, oMax ) ; // use all 3 tri verts.
         
         if( !overlaps( meMin, meMax, oMin, oMax ) )
@@ -751,12 +2326,15 @@ public:
   
   // TO PUSH THE TRI OUT OF THE HULL, TRANSLATE THE TRI BY +PENETRATION
   // TO PUSH THE HULL BACK, TRANSLATE THE HULL BY -PENETRATION
-  bool intersectsTri( const PrecomputedTriangle& tri, Vector3f& penetration ) const {
+  bool intersectsTri( const PrecomputedTriangle& worldTri, Vector3f& penetration ) const {
+    materialize( TransformedSoA | TransformedNormals ) ;
+    PrecomputedTriangle movedTri ;
+    const PrecomputedTriangle& tri = toMySpace( worldTri, movedTri ) ;
     float minOverlap = HUGE ;
     Vector3f axisOfMinOverlap ;
     
     float meMin, meMax, oMin, oMax, lowerLim, upperLim ;
-    SATtest( tri.plane.normal, transformedPts, meMin, meMax ) ;
+    SATtest( tri.plane.normal, transformedSoA, meMin, meMax ) ;
     SATtest( tri.plane.normal, tri.a, oMin, oMax ) ; //Only need to test 1 pt from tri, since all 3 will collapse to same pt.
     
     // Because the tri is going to appear as a POINT in the test, 
@@ -777,7 +2355,7 @@ public:
     //triPts.push_back( tri.a ) ;  triPts.push_back( tri.b ) ;  triPts.push_back( tri.c ) ;
     for( int i = 0 ; i < transformedNormals.size() ; i++ )
     {
-      SATtest( transformedNormals[i], transformedPts, meMin, meMax ) ;
+      SATtest( transformedNormals[i], transformedSoA, meMin, meMax ) ;
       SATtest( transformedNormals[i], &tri.a, 3, oMin, oMax ) ; // use all 3 tri verts.
       
       if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) ) {
@@ -807,7 +2385,7 @@ public:
         if( axis.allzero() ) skip ;
         axis.normalize() ;
         
-        SATtest( axis, transformedPts, meMin, meMax ) ;
+        SATtest( axis, transformedSoA, meMin, meMax ) ;
         SATtest( axis, &tri.a, 3, oMin, oMax ) ; // use all 3 tri verts.
         
         if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) )
@@ -821,20 +2399,23 @@ public:
       }
     }
     
-    penetration = axisOfMinOverlap*minOverlap ;
+    penetration = pose.dir( axisOfMinOverlap*minOverlap ) ;
     return 1 ;
     
   }
   
   // The contact point is also generated.
-  bool intersectsTri( const PrecomputedTriangle& tri, Vector3f& penetration, Vector3f &contact ) const {
+  bool intersectsTri( const PrecomputedTriangle& worldTri, Vector3f& penetration, Vector3f &contact ) const {
+    materialize( TransformedPts | TransformedSoA | TransformedTris ) ;
+    PrecomputedTriangle movedTri ;
+    const PrecomputedTriangle& tri = toMySpace( worldTri, movedTri ) ;
     float minOverlap = HUGE ;
     Vector3f axisOfMinOverlap ;
     const PrecomputedTriangle *pTriMinOverlap ;
     
     // 1. Test the tri.
     float meMin, meMax, oMin, oMax, lowerLim, upperLim ;
-    SATtest( tri.plane.normal, transformedPts, meMin, meMax ) ;
+    SATtest( tri.plane.normal, transformedSoA, meMin, meMax ) ;
     SATtest( tri.plane.normal, tri.a, oMin, oMax ) ; //Only need to test 1 pt from tri, since all 3 will collapse to same pt.
     
     if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) )
@@ -848,7 +2429,7 @@ public:
     // 2. Test the hull's tris
     for( int i = 0 ; i < transformedTris.size() ; i++ )
     {
-      SATtest( transformedTris[i].plane.normal, transformedPts, meMin, meMax ) ;
+      SATtest( transformedTris[i].plane.normal, transformedSoA, meMin, meMax ) ;
       SATtest( transformedTris[i].plane.normal, &tri.a, 3, oMin, oMax ) ; // use all 3 tri verts.
       
       if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) ) {
@@ -874,7 +2455,7 @@ public:
         if( axis.allzero() ) skip ;
         axis.normalize() ;
         
-        SATtest( axis, transformedPts, meMin, meMax ) ;
+        SATtest( axis, transformedSoA, meMin, meMax ) ;
         SATtest( axis, &tri.a, 3, oMin, oMax ) ; // use all 3 tri verts.
         
         if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) )
@@ -898,7 +2479,7 @@ public:
         if( axis.allzero() ) skip ;
         axis.normalize() ;
         
-        SATtest( axis, transformedPts, meMin, meMax ) ;
+        SATtest( axis, transformedSoA, meMin, meMax ) ;
         SATtest( axis, &tri.a, 3, oMin, oMax ) ; // use all 3 tri verts.
         
         if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) )
@@ -917,7 +2498,7 @@ public:
     }
     
     
-    penetration = axisOfMinOverlap*minOverlap ;
+    penetration = pose.dir( axisOfMinOverlap*minOverlap ) ;
     
     // Umm... You take your axis of minimal overlap, project the first polygon on it,
     // find the point(s) with the biggest dot product results, then do the same with
@@ -932,11 +2513,7 @@ public:
     ///*
     // On the convex hull we only want the pt of min pene
     // The pt generated is VERY reasonable.
-    int meSmall=0,meLarge=0;
-    SATGetPtsWithExtremeDots( axisOfMinOverlap, transformedPts, meSmall, meLarge ) ;
-    ////addDebugPoint( transformedPts[meSmall], DarkGreen ) ;
-    ////addDebugPoint( transformedPts[meLarge], Green ) ;
-    contact = transformedPts[meSmall] ;
+    contact = pose.pt( transformedPts[ support( -axisOfMinOverlap, 0 ) ] ) ;
     //*/
     
     
@@ -949,7 +2526,7 @@ public:
     if( pTriMinOverlap )
     {
       Vector3f off = pTriMinOverlap->plane.normal*0.01f;
-      addDebugTriSolid( pTriMinOverlap->a+off, pTriMinOverlap->b+off, pTriMinOverlap->c+off, Green ) ;
+      addDebugTriSolid( pose.pt( pTriMinOverlap->a+off ), pose.pt( pTriMinOverlap->b+off ), pose.pt( pTriMinOverlap->c+off ), Green ) ;
     }
     
     return 1 ;
@@ -965,194 +2542,508 @@ public:
     return intersectsSphere( center, r, closestPtOnHull ) ;
   }
   
-  bool intersectsHull( const Hull& o ) const {
-    // Get the normals for one of the shapes,
-    float meMin, meMax, oMin, oMax ;
-    
+  // Gauss map test (Gregorius, "The Separating Axis Test between Convex Polyhedra", GDC 2013).
+  // On the unit sphere an edge is the arc between the normals of the 2 polygons it joins.
+  // My edge and o's edge only make a face of the Minkowski difference (me - o), so only give
+  // a candidate separating axis, if my edge's arc crosses the arc of o's edge with its normals negated.
+  // op is poseFrom( o ).
+  bool isMinkowskiFace( const HullEdge& edge, const Hull& o, const HullPose& op, const HullEdge& oEdge ) const
+  {
+    const Vector3f& a = transformedPlanes[ edge.poly[0] ].normal ;
+    const Vector3f& b = transformedPlanes[ edge.poly[1] ].normal ;
+    Vector3f c = -op.dir( o.transformedPlanes[ oEdge.poly[0] ].normal ) ;
+    Vector3f d = -op.dir( o.transformedPlanes[ oEdge.poly[1] ].normal ) ;
+    
+    // The planes of the arcs.  b x a runs along the edge (b->a), but use the edge itself:
+    // on a flat hull a and b are opposite, and b x a is 0 while the arc is still the half circle around the edge.
+    Vector3f bxa = transformedPts[ edge.a ] - transformedPts[ edge.b ] ;
+    Vector3f dxc = op.dir( o.transformedPts[ oEdge.a ] - o.transformedPts[ oEdge.b ] ) ;
+    float cba = c.dot( bxa ), dba = d.dot( bxa ) ;
+    float adc = a.dot( dxc ), bdc = b.dot( dxc ) ;
+    
+    // c,d on opposite sides of a,b's great circle, a,b on opposite sides of c,d's,
+    // and on the same hemisphere (not the arcs' antipodes crossing)
+    return cba*dba < 0 && adc*bdc < 0 && cba*bdc > 0 ;
+  }
+  
+  // Feeds every candidate separating axis between me and o to sat: my normals, o's, then the
+  // CROSS of my edges with o's.  Stops as soon as sat finds a separating axis, returning 0.
+  // The axes are in my space, op is poseFrom( o ).
+  bool addSATAxes( const Hull& o, const HullPose& op, SATBlockTest& sat ) const
+  {
     for( int i = 0 ; i < transformedNormals.size() ; i++ )
-    {
-      SATtest( transformedNormals[i], transformedPts, meMin, meMax ) ;
-      SATtest( transformedNormals[i], o.transformedPts, oMin, oMax ) ;
-      if( !overlaps( meMin, meMax, oMin, oMax ) )
+      if( !sat.add( transformedNormals[i] ) )
         return 0 ; // NO OVERLAP IN AT LEAST 1 AXIS, SO NO INTERSECTION
-      // otherwise, go on with the next test
-    }
-
+    
     // TEST SHAPE2.normals as well
     for( int i = 0 ; i < o.transformedNormals.size() ; i++ )
-    {
-      SATtest( o.transformedNormals[i], transformedPts, meMin, meMax ) ;
-      SATtest( o.transformedNormals[i], o.transformedPts, oMin, oMax ) ;
-      if( !overlaps( meMin, meMax, oMin, oMax ) )
-        return 0 ; // NO OVERLAP IN AT LEAST 1 AXIS, SO NO INTERSECTION
-    }
+      if( !sat.add( op.dir( o.transformedNormals[i] ) ) )
+        return 0 ;
     
-    // 3. For accurate results, need test CROSSES
-    // 3. Test the CROSS of every triangle edge axis with every hull edge axis
-    for( int i = 0 ; i < transformedTris.size() ; i++ )
+    // 3. Test the CROSS of my edges with o's edges, for the edge pairs that make a face of the
+    // Minkowski difference.  The rest can't separate us, so they're skipped before projecting anything.
+    for( int i = 0 ; i < finalEdges.size() ; i++ )
     {
-      for( int j = 0 ; j < o.transformedTris.size() ; j++ )
+      for( int j = 0 ; j < o.finalEdges.size() ; j++ )
       {
-        for( int edgeNo = 0 ; edgeNo < 3 ; edgeNo++ )
-        {
-          Vector3f axis = transformedTris[i].plane.normal.cross( o.transformedTris[j].edges[ edgeNo ] ) ;
-          if( axis.allzero() ) skip ;
-          axis.normalize() ;
-          
-          SATtest( axis, transformedPts, meMin, meMax ) ;
-          SATtest( axis, o.transformedPts, oMin, oMax ) ;
-          
-          if( !overlaps( meMin, meMax, oMin, oMax ) )
-            return 0 ;
-        }
-        
-        
-        
-        for( int edgeNo = 0 ; edgeNo < 3 ; edgeNo++ )
-        {
-          Vector3f axis = transformedTris[i].edges[ edgeNo ].cross( o.transformedTris[j].plane.normal ) ;
-          if( axis.allzero() ) skip ;
-          axis.normalize() ;
-          
-          SATtest( axis, transformedPts, meMin, meMax ) ;
-          SATtest( axis, o.transformedPts, oMin, oMax ) ;
-          
-          if( !overlaps( meMin, meMax, oMin, oMax ) )
-            return 0 ;
-        }
+        if( !isMinkowskiFace( finalEdges[i], o, op, o.finalEdges[j] ) )  skip ;
+        Vector3f axis = transformedEdgeDirs[ finalEdges[i].dir ].cross( op.dir( o.transformedEdgeDirs[ o.finalEdges[j].dir ] ) ) ;
+        if( axis.allzero() ) skip ; // parallel edges
+        axis.normalize() ;
+        if( !sat.add( axis ) )
+          return 0 ;
       }
     }
     
+    // the last, part-full block
+    return sat.flush() ;
+  }
+  
+  // The axes go through SATBlockTest, which projects both of us onto a few axes per pass over
+  // each transformedSoA rather than 1, and gives up at the first block with a separating axis.
+  // What SAT between 2 hulls reads
+  enum { SATArrays = TransformedPts | TransformedSoA | TransformedNormals | TransformedPlanes | TransformedEdgeDirs } ;
+  
+  // The test runs in my space: o's pts get projected through poseFrom( o ).
+  bool intersectsHull( const Hull& o ) const {
+    materialize( SATArrays ) ;  o.materialize( SATArrays ) ;
+    HullPose op = poseFrom( o ) ;
+    SATBlockTest sat( transformedSoA, o.transformedSoA ) ;
+    if( op.moved )  sat.moveO( op.rotT, op.pos ) ;
     // if overlap occurred in ALL AXES, then they do intersect
-    return 1 ;
+    return addSATAxes( o, op, sat ) ;
   }
   
   
-  // With separation vector.
+  // With separation vector: moving me by -penetration clears o.
+  // contact1 is my deepest pt along it, contact2 o's.
   bool intersectsHull( const Hull& o, Vector3f &penetration, Vector3f &contact1, Vector3f &contact2 ) const {
+    materialize( SATArrays ) ;  o.materialize( SATArrays ) ;
+    HullPose op = poseFrom( o ) ;
+    SATBlockTest sat( transformedSoA, o.transformedSoA ) ;
+    if( op.moved )  sat.moveO( op.rotT, op.pos ) ;
+    if( !addSATAxes( o, op, sat ) )
+      return 0 ;
     
-    // Vars for penetration distance.
-    Vector3f axisOfMinOverlap ;
-    float minOverlap = HUGE ;
-    const PrecomputedTriangle *pTriMinOverlap ;
-
-    float meMin, meMax, oMin, oMax, lowerLim, upperLim ;
+    penetration = pose.dir( sat.axisOfMinOverlap*sat.minOverlap ) ;
     
-    for( int i = 0 ; i < transformedNormals.size() ; i++ )
+    // On the convex hull we only want the pt of min pene
+    // The pt generated is VERY reasonable.
+    contact1 = pose.pt( transformedPts[ support( sat.axisOfMinOverlap, 0 ) ] ) ;
+    contact2 = o.pose.pt( o.transformedPts[ o.support( op.dirBack( -sat.axisOfMinOverlap ), 0 ) ] ) ;
+    
+    // if overlap occurred in ALL AXES, then they do intersect
+    return 1 ;
+  }
+  
+  // The transformedPt furthest along dir (in my space, like transformedPts), by hill climbing over ptNeighbours from hint: on a convex
+  // hull, a pt that none of its neighbours beats is the furthest.  When you ask along a dir near
+  // the last one (the next GJK step, the same pair next frame), pass the last answer as the hint
+  // and it's usually found in a step or two, instead of looking at every pt.
+  int support( const Vector3f& dir, int hint ) const {
+    materialize( TransformedPts ) ;
+    // A small hull is quicker to just scan than to climb around
+    const int MinPtsToClimb = 32 ;
+    if( transformedPts.size() < MinPtsToClimb || hint < 0 || hint >= transformedPts.size() ||
+        ptNeighbourStart.size() != transformedPts.size()+1 )
+      return support( dir ) ;
+    
+    int best = hint ;
+    float bestDot = transformedPts[best].dot( dir ) ;
+    for( ;; )
     {
-      SATtest( transformedNormals[i], transformedPts, meMin, meMax ) ;
-      SATtest( transformedNormals[i], o.transformedPts, oMin, oMax ) ;
-      
-      if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) ) {
-        //addDebugLine( transformedNormals[i]*meMin, transformedNormals[i]*meMax, Red ) ;
-        //addDebugLine( transformedNormals[i]*oMin, transformedNormals[i]*oMax, Blue ) ;
-        return 0 ; // NO OVERLAP IN AT LEAST 1 AXIS, SO NO INTERSECTION
-      }
-      
-      float overlap=upperLim-lowerLim ;
-      if( overlap < minOverlap ) {
-        axisOfMinOverlap = transformedTris[i].plane.normal ;
-        minOverlap = overlap ;
-        pTriMinOverlap = &transformedTris[i];
+      int from = best ;
+      for( int j = ptNeighbourStart[from] ; j < ptNeighbourStart[from+1] ; j++ )
+      {
+        float d = transformedPts[ ptNeighbours[j] ].dot( dir ) ;
+        if( d > bestDot ) {
+          bestDot = d ;
+          best = ptNeighbours[j] ;
+        }
       }
+      if( best == from )  return best ;
     }
-
-    // TEST SHAPE2.normals as well
-    for( int i = 0 ; i < o.transformedNormals.size() ; i++ )
+  }
+  
+  // The transformedPt furthest along dir.  A linear scan.
+  int support( const Vector3f& dir ) const {
+    materialize( TransformedPts ) ;
+    int best = 0 ;
+    float bestDot = -HUGE ;
+    for( int i = 0 ; i < transformedPts.size() ; i++ )
     {
-      SATtest( o.transformedNormals[i], transformedPts, meMin, meMax ) ;
-      SATtest( o.transformedNormals[i], o.transformedPts, oMin, oMax ) ;
-      if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) ) {
-        //addDebugLine( transformedNormals[i]*meMin, transformedNormals[i]*meMax, Red ) ;
-        //addDebugLine( transformedNormals[i]*oMin, transformedNormals[i]*oMax, Blue ) ;
-        return 0 ; // NO OVERLAP IN AT LEAST 1 AXIS, SO NO INTERSECTION
+      float d = transformedPts[i].dot( dir ) ;
+      if( d > bestDot ) {
+        bestDot = d ;
+        best = i ;
       }
+    }
+    return best ;
+  }
+  
+  // Boolean hull-hull test by GJK (Gilbert, Johnson & Keerthi 1988): walks a simplex over
+  // the Minkowski difference (me - o) towards the origin, which is inside it iff we intersect.
+  // Each step is one support() on each hull, so it costs about (V1+V2) per iteration and
+  // usually takes only a handful of iterations, instead of intersectsHull's projections per axis.
+  // If it does intersect, the simplex (if you pass one) is left holding the origin.
+  // Falls back on intersectsHull (SAT) if it doesn't converge (flat, nearly touching cases).
+  bool intersectsHullGJK( const Hull& o, GJKSimplex* pSimplex=0 ) const {
+    GJKSimplex local ;
+    GJKSimplex& simplex = pSimplex ? *pSimplex : local ;
+    if( transformedPts.empty() || o.transformedPts.empty() )  return 0 ;
+    materialize( TransformedPts ) ;  o.materialize( TransformedPts ) ;
+    
+    Vector3f dir = transformedPts[0] - poseFrom( o ).pt( o.transformedPts[0] ) ;
+    int meI = 0, oI = 0 ;
+    return intersectsHullGJK( o, simplex, dir, meI, oI ) ;
+  }
+  
+  // GJK starting out along dir, climbing from support pts meI and oI (HullPairCache passes in
+  // what the last query on this pair ended with).  When it comes back 0, dir is left as an axis
+  // that separates us (me below o along it), unless it had to fall back on SAT, when dir is 0.
+  // meI and oI are left as the last support pts.  dir and the simplex are in my space.
+  bool intersectsHullGJK( const Hull& o, GJKSimplex& simplex, Vector3f& dir, int& meI, int& oI ) const {
+    if( dir.allzero() )  dir = Vector3f( 1, 0, 0 ) ;
+    materialize( TransformedPts ) ;  o.materialize( TransformedPts ) ;
+    HullPose op = poseFrom( o ) ;
+    
+    simplex.n = 0 ;
+    meI = support( dir, meI ), oI = o.support( op.dirBack( -dir ), oI ) ;
+    simplex.push( transformedPts[meI] - op.pt( o.transformedPts[oI] ), meI, oI ) ;
+    dir = -simplex.pts[0] ;
+    
+    const int MaxIters = 64 ;
+    for( int iter = 0 ; iter < MaxIters ; iter++ )
+    {
+      if( dir.allzero() )  return 1 ; // origin is on the simplex: touching
       
-      float overlap=upperLim-lowerLim ;
-      if( overlap < minOverlap ) {
-        axisOfMinOverlap = transformedTris[i].plane.normal ;
-        minOverlap = overlap ;
-        pTriMinOverlap = &transformedTris[i];
-      }
+      // climb from the last support pts: the dirs don't swing far between steps
+      meI = support( dir, meI ), oI = o.support( op.dirBack( -dir ), oI ) ;
+      Vector3f pt = transformedPts[meI] - op.pt( o.transformedPts[oI] ) ;
+      if( pt.dot( dir ) < 0 )
+        return 0 ; // the furthest the difference reaches towards the origin falls short of it
+      
+      // Got back a vertex we already have: we can't get any closer, and can't tell for sure.
+      for( int i = 0 ; i < simplex.n ; i++ )
+        if( simplex.me[i] == meI && simplex.o[i] == oI ) {
+          dir = Vector3f() ;
+          return intersectsHull( o ) ;
+        }
+      
+      simplex.push( pt, meI, oI ) ;
+      if( gjkDoSimplex( simplex, dir ) )
+        return 1 ;
+    }
+    
+    dir = Vector3f() ;
+    return intersectsHull( o ) ;
+  }
+  
+  // Penetration by EPA (the Expanding Polytope Algorithm, van den Bergen 2001), grown from
+  // the simplex intersectsHullGJK ends on.  It blows that simplex up into a polytope inside the
+  // Minkowski difference (me - o), always pushing out its face nearest the origin, until that face
+  // is on the difference's surface.  That face's normal and distance are the contact normal and depth:
+  // penetration = normal*depth, and moving me by -penetration just clears o.
+  // contact1 is my deepest pt inside o, contact2 the pt on o's surface it has to move back to.
+  // Falls back on the SAT intersectsHull if it can't get a start polytope around the origin,
+  // or if the polytope hasn't reached the surface after MaxIters passes.
+  bool intersectsHullEPA( const Hull& o, Vector3f& penetration, Vector3f& contact1, Vector3f& contact2 ) const
+  {
+    GJKSimplex simplex ;
+    if( !intersectsHullGJK( o, &simplex ) )  return 0 ;
+    HullPose op = poseFrom( o ) ;
+    if( !epaSeedTet( o, op, simplex ) )
+      return intersectsHull( o, penetration, contact1, contact2 ) ;
+    
+    struct EPAFace { int v[3] ; Vector3f n ; float d ; } ;
+    vector<Vector3f> pts ;
+    vector<int> meI, oI ;
+    vector<EPAFace> polytope ;
+    float scale = 0 ;
+    for( int i = 0 ; i < 4 ; i++ )
+    {
+      pts.push_back( simplex.pts[i] ) ;  meI.push_back( simplex.me[i] ) ;  oI.push_back( simplex.o[i] ) ;
+      scale = max( scale, simplex.pts[i].len() ) ;
     }
+    const float Tol = 1e-5f * max( scale, 1.f ) ;
+    
+    // The plane of face a,b,c, wound so its normal points away from the origin
+    auto makeFace = [&]( int a, int b, int c ) {
+      EPAFace face ;
+      face.v[0] = a, face.v[1] = b, face.v[2] = c ;
+      face.n = ( pts[b] - pts[a] ).cross( pts[c] - pts[a] ) ;
+      float len = face.n.len() ;
+      if( len == 0 ) {
+        face.d = HUGE ; // degenerate, never the nearest
+        return face ;
+      }
+      face.n /= len ;
+      face.d = face.n.dot( pts[a] ) ;
+      return face ;
+    } ;
     
+    // Wind the tet's faces outwards, using the vertex each one leaves out
+    static const int TetFaces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } } ;
+    for( int f = 0 ; f < 4 ; f++ )
+    {
+      const int* t = TetFaces[f] ;
+      Vector3f n = ( pts[t[1]] - pts[t[0]] ).cross( pts[t[2]] - pts[t[0]] ) ;
+      if( n.dot( pts[t[3]] - pts[t[0]] ) > 0 )  polytope.push_back( makeFace( t[0], t[2], t[1] ) ) ;
+      else  polytope.push_back( makeFace( t[0], t[1], t[2] ) ) ;
+    }
     
-    // 3. For accurate results, need test CROSSES
-    // 3. Test the CROSS of every triangle edge axis with every hull edge axis
-    for( int i = 0 ; i < transformedTris.size() ; i++ )
+    const int MaxIters = 64 ;
+    bool converged = 0 ;
+    for( int iter = 0 ; iter < MaxIters && !converged ; iter++ )
     {
-      for( int j = 0 ; j < o.transformedTris.size() ; j++ )
+      int nearest = 0 ;
+      for( int f = 1 ; f < polytope.size() ; f++ )
+        if( polytope[f].d < polytope[nearest].d )
+          nearest = f ;
+      
+      // Push the nearest face out as far as the difference goes in its direction
+      Vector3f n = polytope[nearest].n ;
+      int start = polytope[nearest].v[0] ; // one of its corners, as the support hint
+      int meS = support( n, meI[ start ] ), oS = o.support( op.dirBack( -n ), oI[ start ] ) ;
+      Vector3f w = transformedPts[meS] - op.pt( o.transformedPts[oS] ) ;
+      if( w.dot( n ) - polytope[nearest].d < Tol ) {
+        converged = 1 ; // it's already on the surface
+        break ;
+      }
+      
+      bool have = 0 ;
+      for( int i = 0 ; i < pts.size() && !have ; i++ )
+        have = meI[i] == meS && oI[i] == oS ;
+      if( have ) {
+        converged = 1 ; // no further to go
+        break ;
+      }
+      
+      int wi = (int)pts.size() ;
+      pts.push_back( w ) ;  meI.push_back( meS ) ;  oI.push_back( oS ) ;
+      
+      // Cut out every face w sees.  The edges around the hole, the ones only 1 cut face has,
+      // get joined up to w.
+      vector< pair<int,int> > horizon ;
+      for( int f = 0 ; f < polytope.size() ; )
       {
-        // tt's normals against o.tt's edges
-        for( int edgeNo = 0 ; edgeNo < 3 ; edgeNo++ )
-        {
-          Vector3f axis = transformedTris[i].plane.normal.cross( o.transformedTris[j].edges[ edgeNo ] ) ;
-          if( axis.allzero() ) skip ;
-          axis.normalize() ;
-          
-          SATtest( axis, transformedPts, meMin, meMax ) ;
-          SATtest( axis, o.transformedPts, oMin, oMax ) ;
-          
-          if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) )
-            return 0 ;
-          
-          float overlap=upperLim-lowerLim ;
-          if( overlap < minOverlap ) {
-            axisOfMinOverlap = axis ;
-            minOverlap = overlap ;
-            // This is a cross product between edges.
-            //pTriMinOverlap=&transformedTris[i];
-            pTriMinOverlap=0;
-          }
-        }
-        
-        // and tt's edges against o.tt's normals
-        for( int edgeNo = 0 ; edgeNo < 3 ; edgeNo++ )
+        const EPAFace& face = polytope[f] ;
+        if( face.n.dot( w - pts[ face.v[0] ] ) > -Tol ) // and the faces w is (nearly) in the plane of, or the new ones fold
         {
-          Vector3f axis = transformedTris[i].edges[ edgeNo ].cross( o.transformedTris[j].plane.normal ) ;
-          if( axis.allzero() ) skip ;
-          axis.normalize() ;
-          
-          SATtest( axis, transformedPts, meMin, meMax ) ;
-          SATtest( axis, o.transformedPts, oMin, oMax ) ;
-          
-          if( !maxOverlaps( meMin, meMax, oMin, oMax, lowerLim, upperLim ) )
-            return 0 ;
-          
-          float overlap=upperLim-lowerLim ;
-          if( overlap < minOverlap ) {
-            axisOfMinOverlap = axis ;
-            minOverlap = overlap ;
-            pTriMinOverlap=0;
+          for( int k = 0 ; k < 3 ; k++ )
+          {
+            pair<int,int> edge( face.v[k], face.v[(k+1)%3] ) ;
+            bool shared = 0 ;
+            for( int h = 0 ; h < horizon.size() ; h++ )
+              if( horizon[h].first == edge.second && horizon[h].second == edge.first ) {
+                horizon.erase( horizon.begin() + h ) ;
+                shared = 1 ;
+                break ;
+              }
+            if( !shared )  horizon.push_back( edge ) ;
           }
+          polytope[f] = polytope.back() ;
+          polytope.pop_back() ;
         }
+        else  f++ ;
       }
+      
+      for( int h = 0 ; h < horizon.size() ; h++ )
+        polytope.push_back( makeFace( horizon[h].first, horizon[h].second, wi ) ) ;
+      
+      if( polytope.empty() )
+        return intersectsHull( o, penetration, contact1, contact2 ) ;
     }
     
+    // Out of passes: the last one already cut the nearest face out, and the polytope
+    // isn't on the surface anyway.
+    if( !converged )
+      return intersectsHull( o, penetration, contact1, contact2 ) ;
+    
+    int nearest = 0 ;
+    for( int f = 1 ; f < polytope.size() ; f++ )
+      if( polytope[f].d < polytope[nearest].d )
+        nearest = f ;
+    
+    // The nearest pt to the origin on that face, as barycentric coords,
+    // gives the witness pts on each hull.
+    const EPAFace& face = polytope[nearest] ;
+    Vector3f closest = face.n * face.d ;
+    const Vector3f &a = pts[ face.v[0] ], &b = pts[ face.v[1] ], &c = pts[ face.v[2] ] ;
+    Vector3f v0 = b - a, v1 = c - a, v2 = closest - a ;
+    float d00 = v0.dot( v0 ), d01 = v0.dot( v1 ), d11 = v1.dot( v1 ), d20 = v2.dot( v0 ), d21 = v2.dot( v1 ) ;
+    float denom = d00*d11 - d01*d01 ;
+    float u = 1, v = 0, wb = 0 ;
+    if( denom != 0 ) {
+      v = ( d11*d20 - d01*d21 ) / denom ;
+      wb = ( d00*d21 - d01*d20 ) / denom ;
+      u = 1 - v - wb ;
+    }
     
-    penetration = axisOfMinOverlap*minOverlap ;
-    
-    // On the convex hull we only want the pt of min pene
-    // The pt generated is VERY reasonable.
-    int meSmall=0,meLarge=0;
-    SATGetPtsWithExtremeDots( axisOfMinOverlap, transformedPts, meSmall, meLarge ) ;
-    ////addDebugPoint( transformedPts[meSmall], DarkGreen ) ;
-    ////addDebugPoint( transformedPts[meLarge], Green ) ;
-    contact1 = transformedPts[meSmall] ;
+    // (all of that was in my space)
+    penetration = pose.dir( closest ) ;
+    contact1 = pose.pt( transformedPts[ meI[face.v[0]] ]*u + transformedPts[ meI[face.v[1]] ]*v + transformedPts[ meI[face.v[2]] ]*wb ) ;
+    contact2 = o.pose.pt( o.transformedPts[ oI[face.v[0]] ]*u + o.transformedPts[ oI[face.v[1]] ]*v + o.transformedPts[ oI[face.v[2]] ]*wb ) ;
+    return 1 ;
+  }
+  
+  // Fills a GJK simplex that ended on the origin out to a tet (touching contacts end on
+  // a pt, segment or triangle), and checks the tet really holds the origin.
+  bool epaSeedTet( const Hull& o, const HullPose& op, GJKSimplex& s ) const
+  {
+    static const Vector3f Axes[6] = { Vector3f(1,0,0), Vector3f(-1,0,0), Vector3f(0,1,0),
+                                      Vector3f(0,-1,0), Vector3f(0,0,1), Vector3f(0,0,-1) } ;
+    if( s.n == 0 )  return 0 ;
     
-    SATGetPtsWithExtremeDots( axisOfMinOverlap, o.transformedPts, meSmall, meLarge ) ;
-    contact2 = o.transformedPts[meLarge] ;
+    // Directions that might get a pt off the current line/plane
+    for( int tries = 0 ; s.n < 4 && tries < 12 ; tries++ )
+    {
+      Vector3f dir ;
+      if( s.n == 1 )  dir = Axes[ tries%6 ] ;
+      else if( s.n == 2 ) {
+        Vector3f seg = s.pts[1] - s.pts[0] ;
+        dir = seg.cross( Axes[ tries%6 ] ) ;
+      }
+      else {
+        dir = ( s.pts[1] - s.pts[0] ).cross( s.pts[2] - s.pts[0] ) ;
+        if( tries%2 )  dir = -dir ;
+      }
+      if( dir.allzero() )  skip ;
+      
+      int meI = support( dir, s.me[s.n-1] ), oI = o.support( op.dirBack( -dir ), s.o[s.n-1] ) ;
+      Vector3f pt = transformedPts[meI] - op.pt( o.transformedPts[oI] ) ;
+      
+      // Only take it if it adds a dimension
+      bool adds ;
+      if( s.n == 1 )  adds = !( pt - s.pts[0] ).allzero() ;
+      else if( s.n == 2 )  adds = !( s.pts[1] - s.pts[0] ).cross( pt - s.pts[0] ).allzero() ;
+      else  adds = ( s.pts[1] - s.pts[0] ).cross( s.pts[2] - s.pts[0] ).dot( pt - s.pts[0] ) != 0 ;
+      if( adds )  s.push( pt, meI, oI ) ;
+    }
+    if( s.n < 4 )  return 0 ; // one of the hulls is flat
     
-    // if overlap occurred in ALL AXES, then they do intersect
+    // The origin has to be on the inside of (or on) each face
+    static const int TetFaces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } } ;
+    for( int f = 0 ; f < 4 ; f++ )
+    {
+      const int* t = TetFaces[f] ;
+      Vector3f n = ( s.pts[t[1]] - s.pts[t[0]] ).cross( s.pts[t[2]] - s.pts[t[0]] ) ;
+      float opposite = n.dot( s.pts[t[3]] - s.pts[t[0]] ), origin = n.dot( -s.pts[t[0]] ) ;
+      if( opposite == 0 || opposite*origin < 0 )  return 0 ;
+    }
     return 1 ;
   }
   
+private:
+  // Cuts the simplex down to the feature nearest the origin and points dir from it
+  // at the origin.  Returns 1 if the simplex contains the origin.
+  static bool gjkDoSimplex( GJKSimplex& s, Vector3f& dir )
+  {
+    if( s.n == 4 )
+    {
+      // a is the newest.  The origin can't be past the face opposite it (that was the
+      // triangle we came from), so check the 3 faces through a.
+      const Vector3f &a = s.pts[3] ;
+      Vector3f ao = -a ;
+      static const int Faces[3][3] = { { 3, 2, 1 }, { 3, 1, 0 }, { 3, 0, 2 } } ; // and the one left out
+      static const int Opposite[3] = { 0, 2, 1 } ;
+      for( int f = 0 ; f < 3 ; f++ )
+      {
+        const Vector3f &b = s.pts[ Faces[f][1] ], &c = s.pts[ Faces[f][2] ] ;
+        Vector3f n = ( b - a ).cross( c - a ) ;
+        if( n.dot( s.pts[ Opposite[f] ] - a ) > 0 )  n = -n ; // point it out of the tet
+        if( n.dot( ao ) > 0 ) {
+          s.keep( Faces[f][2], Faces[f][1], Faces[f][0] ) ;
+          return gjkDoSimplex( s, dir ) ;
+        }
+      }
+      return 1 ; // inside all 4 faces
+    }
+    
+    if( s.n == 3 )
+    {
+      const Vector3f &a = s.pts[2], &b = s.pts[1], &c = s.pts[0] ;
+      Vector3f ab = b - a, ac = c - a, ao = -a ;
+      Vector3f abc = ab.cross( ac ) ;
+      if( abc.allzero() ) {
+        // a landed on the line through b,c: go on with the newer edge
+        s.keep( 1, 2 ) ;
+        return gjkDoSimplex( s, dir ) ;
+      }
+      
+      if( abc.cross( ac ).dot( ao ) > 0 ) {
+        if( ac.dot( ao ) > 0 ) {
+          // nearest the edge ac
+          s.keep( 0, 2 ) ;
+          dir = ac.cross( ao ).cross( ac ) ;
+          return 0 ;
+        }
+        s.keep( 1, 2 ) ;
+        return gjkDoSimplex( s, dir ) ;
+      }
+      if( ab.cross( abc ).dot( ao ) > 0 ) {
+        s.keep( 1, 2 ) ;
+        return gjkDoSimplex( s, dir ) ;
+      }
+      
+      // over or under the triangle
+      float side = abc.dot( ao ) ;
+      if( side == 0 )  return 1 ; // in it
+      dir = side > 0 ? abc : -abc ;
+      return 0 ;
+    }
+    
+    if( s.n == 2 )
+    {
+      const Vector3f &a = s.pts[1], &b = s.pts[0] ;
+      Vector3f ab = b - a, ao = -a ;
+      if( ab.dot( ao ) > 0 ) {
+        dir = ab.cross( ao ).cross( ab ) ;
+        if( dir.allzero() )  return 1 ; // the origin is on the segment
+        return 0 ;
+      }
+      s.keep( 1 ) ;
+      dir = ao ;
+      return 0 ;
+    }
+    
+    dir = -s.pts[0] ;
+    return 0 ;
+  }
+  
+public:
   // SAT test
   bool intersectsAABB( const AABB& aabb ) const {
     // SAT:
     // 3 cube axes
     float meMin, meMax, oMin, oMax ;
     
+    materialize( TransformedPts | TransformedSoA | TransformedNormals ) ;
+    
+    // In local space the box is turned: bring its axes and corners over, and test the same axes.
+    if( pose.moved )
+    {
+      Vector3f corners[8] ;
+      for( int i = 0 ; i < 8 ; i++ )
+        corners[i] = pose.ptBack( aabb.corners[i] ) ;
+      for( int axis = 0 ; axis < 3 ; axis++ )
+      {
+        Vector3f boxAxis = pose.dirBack( Vector3f( axis==0, axis==1, axis==2 ) ) ;
+        SATtest( boxAxis, transformedSoA, meMin, meMax ) ;
+        SATtest( boxAxis, corners, 8, oMin, oMax ) ;
+        if( !overlaps( meMin, meMax, oMin, oMax ) )
+          return 0 ;
+      }
+      for( int i = 0 ; i < transformedNormals.size() ; i++ )
+      {
+        SATtest( transformedNormals[i], transformedSoA, meMin, meMax ) ;
+        SATtest( transformedNormals[i], corners, 8, oMin, oMax ) ;
+        if( !overlaps( meMin, meMax, oMin, oMax ) )
+          return 0 ;
+      }
+      return 1 ;
+    }
+    
     for( int axis = 0 ; axis < 3 ; axis++ )
     {
       // because we're projecting points in 3 space TO THE PRINCIPAL AXES,
@@ -1177,7 +3068,7 @@ public:
     // then test the hull's planes
     for( int i = 0 ; i < transformedNormals.size() ; i++ )
     {
-      SATtest( transformedNormals[i], transformedPts, meMin, meMax ) ;
+      SATtest( transformedNormals[i], transformedSoA, meMin, meMax ) ;
       SATtest( transformedNormals[i], aabb.corners, oMin, oMax ) ;
       if( !overlaps( meMin, meMax, oMin, oMax ) )
         return 0 ;
@@ -1195,9 +3086,11 @@ public:
   bool intersectsSphere( const Sphere& sphere ) const {
     // Can use an INSIDE test, similar to sphere frustum.
     // OR check i'm within sphere.r of each plane
+    materialize( TransformedTris ) ;
+    Vector3f c = pose.ptBack( sphere.c ) ;
     for( int i = 0 ; i < transformedTris.size() ; i++ )
     {
-      float dist = transformedTris[i].plane.distanceToPoint( sphere.c ) ;
+      float dist = transformedTris[i].plane.distanceToPoint( c ) ;
       
       // If the sphere is way outside one of the planes, it doesn't hit the hull.
       if( dist > sphere.r )  return 0 ;
@@ -1209,17 +3102,21 @@ public:
   // rtcd pg 199
   // this is much more efficient than a ray-tri intn on each
   // possible BECAUSE its a convex hull
-  bool intersectsRay( const Ray& ray, float &t1, float &t2 ) const {
+  // t1 and t2 are the same in my space as out of it (the move is rigid), so only the ray is brought over.
+  bool intersectsRay( const Ray& worldRay, float &t1, float &t2 ) const {
+    materialize( TransformedPlanes ) ;
+    Ray ray = pose.moved ? Ray( pose.ptBack( worldRay.start ), pose.dirBack( worldRay.dir ), worldRay.len ) : worldRay ;
+    
     // assume intn is .. whole ray.
     t1=0.f,t2=ray.len ;
     
-    // Test EVERY tri..
-    for( int i = 0 ; i < transformedTris.size() ; i++ )
+    // Test EVERY face plane..
+    for( int i = 0 ; i < transformedPlanes.size() ; i++ )
     {
       // solve t for reaching the plane.
       // The t for reaching the plane would be (-plane.d - normal•ray.start)/(normal • ray.dir)
-      float den = transformedTris[i].plane.normal.dot( ray.dir ) ;
-      float dist = -transformedTris[i].plane.d - transformedTris[i].plane.normal.dot( ray.start ) ;
+      float den = transformedPlanes[i].normal.dot( ray.dir ) ;
+      float dist = -transformedPlanes[i].d - transformedPlanes[i].normal.dot( ray.start ) ;
       
       // If the ray is //l to the plane, but it runs AWAY from the plane,
       // then you'll never hit the convex polyhedron with this ray.
@@ -1288,25 +3185,31 @@ public:
   // Debug functions  
 public:
   void drawDebugLines( const Vector4f& color ) const {
-    for( int i = 0 ; i < indices.size() ; i+=3 )
-      addDebugTriLine( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]], color ) ;
+    for( int i = 0 ; i < faces.size() ; i++ )
+      if( faces[i].alive )
+        addDebugTriLine( verts[faceVert(i,0)], verts[faceVert(i,1)], verts[faceVert(i,2)], color ) ;
   }
 
   void drawDebug( const Vector3f& o, const Vector4f& color ) const {
+    materialize( TransformedTris ) ;
     //for( int i = 0 ; i < indices.size() ; i+=3 )
     //  addDebugTriSolid( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]], color ) ;
     for( int i = 0 ; i < transformedTris.size() ; i++ )
     {
-      addDebugTriSolid( o+transformedTris[i].a, o+transformedTris[i].b, o+transformedTris[i].c, color ) ;
+      addDebugTriSolid( o+pose.pt( transformedTris[i].a ), o+pose.pt( transformedTris[i].b ), o+pose.pt( transformedTris[i].c ), color ) ;
     }
   }
   
   void drawDebug( const Vector4f& color ) const {
+    materialize( TransformedTris ) ;
     //for( int i = 0 ; i < indices.size() ; i+=3 )
     //  addDebugTriSolid( verts[indices[i]], verts[indices[i+1]], verts[indices[i+2]], color ) ;
     for( int i = 0 ; i < transformedTris.size() ; i++ )
     {
-      addDebugTriSolid( transformedTris[i], color ) ;
+      if( pose.moved )
+        addDebugTriSolid( pose.pt( transformedTris[i].a ), pose.pt( transformedTris[i].b ), pose.pt( transformedTris[i].c ), color ) ;
+      else
+        addDebugTriSolid( transformedTris[i], color ) ;
     }
   }
   
@@ -1335,10 +3238,11 @@ public:
   
   void drawDebugFaceNormals() const
   {
+    materialize( TransformedTris ) ;
     for( int i = 0 ; i < transformedTris.size() ; i++ )
     {
-      Vector3f c = transformedTris[i].centroid ;
-      addDebugLine( c, c+transformedTris[i].plane.normal, Yellow ) ;
+      Vector3f c = pose.pt( transformedTris[i].centroid ) ;
+      addDebugLine( c, c+pose.dir( transformedTris[i].plane.normal ), Yellow ) ;
     }
   }
   
@@ -1360,5 +3264,156 @@ public:
   }
 } ;
 
+// How buildHulls builds each hull
+struct HullBuildOptions
+{
+  float tolerance ;      // Hull::tolerance for every hull
+  bool useConflictLists ;
+  bool cullInterior ;
+  bool buildInDouble ;
+  bool exactPredicates ;
+  float maxApproxError ; // > 0 builds each hull with Hull::solveApprox( cloud, maxApproxError )
+  int numThreads ;       // 0 for one per hardware thread
+  
+  HullBuildOptions() {
+    Hull defaultHull ;
+    tolerance = defaultHull.tolerance ;
+    useConflictLists = defaultHull.useConflictLists ;
+    cullInterior = defaultHull.cullInterior ;
+    buildInDouble = defaultHull.buildInDouble ;
+    exactPredicates = defaultHull.exactPredicates ;
+    maxApproxError = 0.f ;
+    numThreads = 0 ;
+  }
+} ;
+
+// Remembers, for each pair of hulls you ask about, how the last query on that pair came out,
+// so that in a coherent scene the next query on it is mostly already answered:
+// if GJK found them apart, the axis it found them apart along usually still separates them
+// next frame, and that takes just 2 support() climbs to check.  Otherwise GJK starts
+// from where it left off last time (its last search dir and support pts).
+//
+// Pairs are keyed by the Hulls' addresses, so forget() a hull you destroy or move
+// (a vector<Hull> that reallocates moves all of them: clear() then).
+struct HullPairCache
+{
+  struct Entry
+  {
+    Vector3f dir ;   // the last GJK search dir, an axis that separated them if `separated`
+    int meI, oI ;    // the last support pts on each hull
+    bool separated ;
+    
+    Entry() : meI(0), oI(0), separated(0) {}
+  } ;
+  
+  struct PairHash {
+    size_t operator()( const pair<const Hull*,const Hull*>& p ) const {
+      return hash<const void*>()( p.first ) ^ ( hash<const void*>()( p.second ) * 31 ) ;
+    }
+  } ;
+  unordered_map< pair<const Hull*,const Hull*>, Entry, PairHash > entries ;
+  
+  // axisHits: answered by the cached separating axis alone.
+  // axisMisses: had an axis, but it didn't separate them anymore, so ran GJK.
+  // coldQueries: first query on the pair (nothing cached), so ran GJK.
+  // Queries on pairs that were intersecting last time run GJK warm and count as neither.
+  long long queries, axisHits, axisMisses, coldQueries ;
+  
+  HullPairCache() { resetCounters() ; }
+  
+  void resetCounters() {
+    queries = axisHits = axisMisses = coldQueries = 0 ;
+  }
+  // The fraction of queries the cached axis answered
+  double hitRate() const {
+    return queries ? (double)axisHits / queries : 0 ;
+  }
+  
+  void clear() { entries.clear() ; }
+  
+  // Drop every pair hull is in
+  void forget( const Hull& hull ) {
+    for( auto iter = entries.begin() ; iter != entries.end() ; )
+    {
+      if( iter->first.first == &hull || iter->first.second == &hull )
+        iter = entries.erase( iter ) ;
+      else
+        ++iter ;
+    }
+  }
+  
+  // Same answer as a.intersectsHull( b )
+  bool intersects( const Hull& a, const Hull& b )
+  {
+    queries++ ;
+    if( a.transformedPts.empty() || b.transformedPts.empty() )  return 0 ;
+    a.materialize( Hull::TransformedPts ) ;  b.materialize( Hull::TransformedPts ) ;
+    
+    // everything's in a's space
+    HullPose bPose = a.poseFrom( b ) ;
+    auto found = entries.find( make_pair( &a, &b ) ) ;
+    if( found == entries.end() ) {
+      coldQueries++ ;
+      found = entries.insert( make_pair( make_pair( &a, &b ), Entry() ) ).first ;
+      found->second.dir = a.transformedPts[0] - bPose.pt( b.transformedPts[0] ) ;
+    }
+    Entry& entry = found->second ;
+    
+    if( entry.separated )
+    {
+      // Still apart along the same axis?
+      entry.meI = a.support( entry.dir, entry.meI ) ;
+      entry.oI = b.support( bPose.dirBack( -entry.dir ), entry.oI ) ;
+      if( a.transformedPts[ entry.meI ].dot( entry.dir ) < bPose.pt( b.transformedPts[ entry.oI ] ).dot( entry.dir ) ) {
+        axisHits++ ;
+        return 0 ;
+      }
+      axisMisses++ ;
+    }
+    
+    GJKSimplex simplex ;
+    bool hit = a.intersectsHullGJK( b, simplex, entry.dir, entry.meI, entry.oI ) ;
+    entry.separated = !hit && !entry.dir.allzero() ;
+    if( entry.dir.allzero() )
+      entry.dir = a.transformedPts[ entry.meI ] - bPose.pt( b.transformedPts[ entry.oI ] ) ;
+    return hit ;
+  }
+} ;
+
+// Builds a hull for each of clouds[0..numClouds), independently, across a thread pool.
+// hulls[i] is the hull of clouds[i], built in place: pass the same vector again next time
+// and each hull's construction buffers (mesh, conflict lists, verts) get reused.
+inline void buildHulls( const PointCloudView* clouds, int numClouds, vector<Hull>& hulls, ThreadPool& pool,
+  const HullBuildOptions& options=HullBuildOptions() )
+{
+  hulls.resize( numClouds ) ;
+  
+  pool.parallelFor( numClouds, [&]( int i, int threadNo ) {
+    Hull& hull = hulls[i] ;
+    hull.clear() ;
+    hull.tolerance = options.tolerance ;
+    hull.useConflictLists = options.useConflictLists ;
+    hull.cullInterior = options.cullInterior ;
+    hull.buildInDouble = options.buildInDouble ;
+    hull.exactPredicates = options.exactPredicates ;
+    hull.debugDraw = 0 ;
+    
+    if( options.maxApproxError > 0.f )
+      hull.solveApprox( clouds[i], options.maxApproxError ) ;
+    else
+    {
+      hull.addPtsToBound( clouds[i] ) ;
+      hull.solve() ;
+    }
+  } ) ;
+}
+
+inline void buildHulls( const PointCloudView* clouds, int numClouds, vector<Hull>& hulls,
+  const HullBuildOptions& options=HullBuildOptions() )
+{
+  ThreadPool pool( options.numThreads ) ;
+  buildHulls( clouds, numClouds, hulls, pool, options ) ;
+}
+
 
 #endif
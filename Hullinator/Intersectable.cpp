@@ -68,6 +68,323 @@ void SATGetPtsWithExtremeDots( const Vector3f& axis, const Vector3f *ptSet, int
   }
 }
 
+void PointsSoA::set( const vector<Vector3f>& pts )
+{
+  n = (int)pts.size() ;
+  int padded = ( n + SoAWidth-1 ) / SoAWidth * SoAWidth ;
+  x.resize( padded ) ;  y.resize( padded ) ;  z.resize( padded ) ;
+  for( int i = 0 ; i < padded ; i++ )
+  {
+    const Vector3f& pt = pts[ i < n ? i : 0 ] ;
+    x[i] = pt.x, y[i] = pt.y, z[i] = pt.z ;
+  }
+}
+
+static void SATtestScalar( const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong )
+{
+  minAlong=HUGE, maxAlong=-HUGE;
+  const float *x = pts.x.data(), *y = pts.y.data(), *z = pts.z.data() ;
+  for( int i = 0 ; i < pts.n ; i++ )
+  {
+    float dotVal = x[i]*axis.x + y[i]*axis.y + z[i]*axis.z ;
+    if( dotVal < minAlong )  minAlong=dotVal;
+    if( dotVal > maxAlong )  maxAlong=dotVal;
+  }
+}
+
+// Batched: the axes AxisTile at a time, each tile one pass over the pts.
+enum { AxisTile = 4 } ;
+
+static void SATtestScalar( const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong )
+{
+  const float *x = pts.x.data(), *y = pts.y.data(), *z = pts.z.data() ;
+  for( int a0 = 0 ; a0 < numAxes ; a0 += AxisTile )
+  {
+    int k = min( (int)AxisTile, numAxes - a0 ) ;
+    float mn[AxisTile], mx[AxisTile] ;
+    for( int j = 0 ; j < AxisTile ; j++ )  mn[j] = HUGE, mx[j] = -HUGE ;
+    for( int i = 0 ; i < pts.n ; i++ )
+      for( int j = 0 ; j < k ; j++ )
+      {
+        const Vector3f& axis = axes[ a0 + j ] ;
+        float dotVal = x[i]*axis.x + y[i]*axis.y + z[i]*axis.z ;
+        if( dotVal < mn[j] )  mn[j]=dotVal;
+        if( dotVal > mx[j] )  mx[j]=dotVal;
+      }
+    for( int j = 0 ; j < k ; j++ )
+      minAlong[ a0 + j ] = mn[j], maxAlong[ a0 + j ] = mx[j] ;
+  }
+}
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define SAT_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SAT_TARGET_AVX2
+#else
+#define SAT_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#endif
+
+static inline void reduceMinMax( __m128 mn, __m128 mx, float& minAlong, float& maxAlong )
+{
+  mn = _mm_min_ps( mn, _mm_movehl_ps( mn, mn ) ) ;
+  mn = _mm_min_ss( mn, _mm_shuffle_ps( mn, mn, 1 ) ) ;
+  mx = _mm_max_ps( mx, _mm_movehl_ps( mx, mx ) ) ;
+  mx = _mm_max_ss( mx, _mm_shuffle_ps( mx, mx, 1 ) ) ;
+  minAlong = _mm_cvtss_f32( mn ) ;
+  maxAlong = _mm_cvtss_f32( mx ) ;
+}
+
+static void SATtestSSE( const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong )
+{
+  const float *x = pts.x.data(), *y = pts.y.data(), *z = pts.z.data() ;
+  int padded = (int)pts.x.size() ;
+  __m128 ax = _mm_set1_ps( axis.x ), ay = _mm_set1_ps( axis.y ), az = _mm_set1_ps( axis.z ) ;
+  __m128 mn = _mm_set1_ps( HUGE ), mx = _mm_set1_ps( -HUGE ) ;
+  for( int i = 0 ; i < padded ; i += 4 )
+  {
+    __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( x+i ), ax ),
+                                       _mm_mul_ps( _mm_loadu_ps( y+i ), ay ) ),
+                                       _mm_mul_ps( _mm_loadu_ps( z+i ), az ) ) ;
+    mn = _mm_min_ps( mn, d ) ;
+    mx = _mm_max_ps( mx, d ) ;
+  }
+  reduceMinMax( mn, mx, minAlong, maxAlong ) ;
+}
+
+// 2 axes per pass here: their 6 broadcast components, 4 accumulators and the 3 loaded
+// coords just fit the 16 xmm/ymm registers, so every pt loaded is used twice.
+static void SATtestSSE( const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong )
+{
+  const float *x = pts.x.data(), *y = pts.y.data(), *z = pts.z.data() ;
+  int padded = (int)pts.x.size() ;
+  for( int a = 0 ; a < numAxes ; a += 2 )
+  {
+    const Vector3f &axis0 = axes[a], &axis1 = axes[ min( a+1, numAxes-1 ) ] ;
+    __m128 ax0 = _mm_set1_ps( axis0.x ), ay0 = _mm_set1_ps( axis0.y ), az0 = _mm_set1_ps( axis0.z ) ;
+    __m128 ax1 = _mm_set1_ps( axis1.x ), ay1 = _mm_set1_ps( axis1.y ), az1 = _mm_set1_ps( axis1.z ) ;
+    __m128 mn0 = _mm_set1_ps( HUGE ), mx0 = _mm_set1_ps( -HUGE ), mn1 = mn0, mx1 = mx0 ;
+    for( int i = 0 ; i < padded ; i += 4 )
+    {
+      __m128 px = _mm_loadu_ps( x+i ), py = _mm_loadu_ps( y+i ), pz = _mm_loadu_ps( z+i ) ;
+      __m128 d0 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, ax0 ), _mm_mul_ps( py, ay0 ) ), _mm_mul_ps( pz, az0 ) ) ;
+      __m128 d1 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, ax1 ), _mm_mul_ps( py, ay1 ) ), _mm_mul_ps( pz, az1 ) ) ;
+      mn0 = _mm_min_ps( mn0, d0 ) ;  mx0 = _mm_max_ps( mx0, d0 ) ;
+      mn1 = _mm_min_ps( mn1, d1 ) ;  mx1 = _mm_max_ps( mx1, d1 ) ;
+    }
+    reduceMinMax( mn0, mx0, minAlong[a], maxAlong[a] ) ;
+    if( a+1 < numAxes )
+      reduceMinMax( mn1, mx1, minAlong[a+1], maxAlong[a+1] ) ;
+  }
+}
+
+SAT_TARGET_AVX2
+static void SATtestAVX2( const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong )
+{
+  const float *x = pts.x.data(), *y = pts.y.data(), *z = pts.z.data() ;
+  int padded = (int)pts.x.size() ;
+  __m256 ax = _mm256_set1_ps( axis.x ), ay = _mm256_set1_ps( axis.y ), az = _mm256_set1_ps( axis.z ) ;
+  // 2 sets of accumulators, so the min/max chains of consecutive blocks can overlap
+  __m256 mn0 = _mm256_set1_ps( HUGE ), mx0 = _mm256_set1_ps( -HUGE ), mn1 = mn0, mx1 = mx0 ;
+  int i = 0 ;
+  for( ; i + 16 <= padded ; i += 16 )
+  {
+    __m256 d0 = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( x+i ), ax ),
+                                              _mm256_mul_ps( _mm256_loadu_ps( y+i ), ay ) ),
+                                              _mm256_mul_ps( _mm256_loadu_ps( z+i ), az ) ) ;
+    __m256 d1 = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( x+i+8 ), ax ),
+                                              _mm256_mul_ps( _mm256_loadu_ps( y+i+8 ), ay ) ),
+                                              _mm256_mul_ps( _mm256_loadu_ps( z+i+8 ), az ) ) ;
+    mn0 = _mm256_min_ps( mn0, d0 ) ;  mx0 = _mm256_max_ps( mx0, d0 ) ;
+    mn1 = _mm256_min_ps( mn1, d1 ) ;  mx1 = _mm256_max_ps( mx1, d1 ) ;
+  }
+  if( i < padded ) // one last block of 8
+  {
+    __m256 d = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( x+i ), ax ),
+                                             _mm256_mul_ps( _mm256_loadu_ps( y+i ), ay ) ),
+                                             _mm256_mul_ps( _mm256_loadu_ps( z+i ), az ) ) ;
+    mn0 = _mm256_min_ps( mn0, d ) ;  mx0 = _mm256_max_ps( mx0, d ) ;
+  }
+  mn0 = _mm256_min_ps( mn0, mn1 ) ;
+  mx0 = _mm256_max_ps( mx0, mx1 ) ;
+  reduceMinMax( _mm_min_ps( _mm256_castps256_ps128( mn0 ), _mm256_extractf128_ps( mn0, 1 ) ),
+                _mm_max_ps( _mm256_castps256_ps128( mx0 ), _mm256_extractf128_ps( mx0, 1 ) ),
+                minAlong, maxAlong ) ;
+}
+
+SAT_TARGET_AVX2
+static void SATtestAVX2( const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong )
+{
+  const float *x = pts.x.data(), *y = pts.y.data(), *z = pts.z.data() ;
+  int padded = (int)pts.x.size() ;
+  for( int a = 0 ; a < numAxes ; a += 2 )
+  {
+    const Vector3f &axis0 = axes[a], &axis1 = axes[ min( a+1, numAxes-1 ) ] ;
+    __m256 ax0 = _mm256_set1_ps( axis0.x ), ay0 = _mm256_set1_ps( axis0.y ), az0 = _mm256_set1_ps( axis0.z ) ;
+    __m256 ax1 = _mm256_set1_ps( axis1.x ), ay1 = _mm256_set1_ps( axis1.y ), az1 = _mm256_set1_ps( axis1.z ) ;
+    __m256 mn0 = _mm256_set1_ps( HUGE ), mx0 = _mm256_set1_ps( -HUGE ), mn1 = mn0, mx1 = mx0 ;
+    for( int i = 0 ; i < padded ; i += 8 )
+    {
+      __m256 px = _mm256_loadu_ps( x+i ), py = _mm256_loadu_ps( y+i ), pz = _mm256_loadu_ps( z+i ) ;
+      __m256 d0 = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( px, ax0 ), _mm256_mul_ps( py, ay0 ) ), _mm256_mul_ps( pz, az0 ) ) ;
+      __m256 d1 = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( px, ax1 ), _mm256_mul_ps( py, ay1 ) ), _mm256_mul_ps( pz, az1 ) ) ;
+      mn0 = _mm256_min_ps( mn0, d0 ) ;  mx0 = _mm256_max_ps( mx0, d0 ) ;
+      mn1 = _mm256_min_ps( mn1, d1 ) ;  mx1 = _mm256_max_ps( mx1, d1 ) ;
+    }
+    reduceMinMax( _mm_min_ps( _mm256_castps256_ps128( mn0 ), _mm256_extractf128_ps( mn0, 1 ) ),
+                  _mm_max_ps( _mm256_castps256_ps128( mx0 ), _mm256_extractf128_ps( mx0, 1 ) ),
+                  minAlong[a], maxAlong[a] ) ;
+    if( a+1 < numAxes )
+      reduceMinMax( _mm_min_ps( _mm256_castps256_ps128( mn1 ), _mm256_extractf128_ps( mn1, 1 ) ),
+                    _mm_max_ps( _mm256_castps256_ps128( mx1 ), _mm256_extractf128_ps( mx1, 1 ) ),
+                    minAlong[a+1], maxAlong[a+1] ) ;
+  }
+}
+
+static bool cpuHasAVX2()
+{
+#ifdef _MSC_VER
+  int info[4] ;
+  __cpuid( info, 1 ) ;
+  bool osxsave = ( info[2] & (1<<27) ) != 0, avx = ( info[2] & (1<<28) ) != 0 ;
+  if( !osxsave || !avx )  return 0 ;
+  if( ( _xgetbv( 0 ) & 6 ) != 6 )  return 0 ; // the OS saves the ymm regs
+  __cpuidex( info, 7, 0 ) ;
+  return ( info[1] & (1<<5) ) != 0 ;
+#else
+  __builtin_cpu_init() ; // may run before constructors, where gcc needs this first
+  return __builtin_cpu_supports( "avx2" ) ;
+#endif
+}
+#endif
+
+const char* SATKernelName[ SATKernelCount ] = { "scalar", "SSE", "AVX2" } ;
+
+bool satKernelSupported( SATKernel kernel )
+{
+  switch( kernel )
+  {
+    case SATKernelScalar: return 1 ;
+#ifdef SAT_X86
+    case SATKernelSSE: return 1 ;
+    case SATKernelAVX2: return cpuHasAVX2() ;
+#endif
+    default: return 0 ;
+  }
+}
+
+SATKernel bestSATKernel()
+{
+  for( int k = SATKernelCount-1 ; k > SATKernelScalar ; k-- )
+    if( satKernelSupported( (SATKernel)k ) )
+      return (SATKernel)k ;
+  return SATKernelScalar ;
+}
+
+void SATtest( SATKernel kernel, const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong )
+{
+  switch( kernel )
+  {
+#ifdef SAT_X86
+    case SATKernelSSE: SATtestSSE( axis, pts, minAlong, maxAlong ) ; break ;
+    case SATKernelAVX2: SATtestAVX2( axis, pts, minAlong, maxAlong ) ; break ;
+#endif
+    default: SATtestScalar( axis, pts, minAlong, maxAlong ) ; break ;
+  }
+}
+
+void SATtest( SATKernel kernel, const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong )
+{
+  switch( kernel )
+  {
+#ifdef SAT_X86
+    case SATKernelSSE: SATtestSSE( axes, numAxes, pts, minAlong, maxAlong ) ; break ;
+    case SATKernelAVX2: SATtestAVX2( axes, numAxes, pts, minAlong, maxAlong ) ; break ;
+#endif
+    default: SATtestScalar( axes, numAxes, pts, minAlong, maxAlong ) ; break ;
+  }
+}
+
+typedef void (*SATKernelFn)( const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong ) ;
+typedef void (*SATBatchKernelFn)( const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong ) ;
+static SATKernelFn pickSATKernel()
+{
+#ifdef SAT_X86
+  switch( bestSATKernel() )
+  {
+    case SATKernelAVX2: return SATtestAVX2 ;
+    case SATKernelSSE: return SATtestSSE ;
+    default: break ;
+  }
+#endif
+  return SATtestScalar ;
+}
+static SATBatchKernelFn pickSATBatchKernel()
+{
+#ifdef SAT_X86
+  switch( bestSATKernel() )
+  {
+    case SATKernelAVX2: return SATtestAVX2 ;
+    case SATKernelSSE: return SATtestSSE ;
+    default: break ;
+  }
+#endif
+  return SATtestScalar ;
+}
+// The picks are function statics, made on the first call, so SATtest works from other
+// files' static initializers too (a namespace static might not be set up yet then).
+void SATtest( const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong )
+{
+  static const SATKernelFn bestKernel = pickSATKernel() ;
+  bestKernel( axis, pts, minAlong, maxAlong ) ;
+}
+
+void SATtest( const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong )
+{
+  static const SATBatchKernelFn bestBatchKernel = pickSATBatchKernel() ;
+  bestBatchKernel( axes, numAxes, pts, minAlong, maxAlong ) ;
+}
+
+bool SATBlockTest::flush()
+{
+  if( !n )  return 1 ;
+  float meMin[ BlockSize ], meMax[ BlockSize ], oMin[ BlockSize ], oMax[ BlockSize ] ;
+  SATtest( axes, n, me, meMin, meMax ) ;
+  if( !oMoved )
+    SATtest( axes, n, o, oMin, oMax ) ;
+  else
+  {
+    // o's pts are projected onto the axes taken into its space, then moved out along them
+    Vector3f oAxes[ BlockSize ] ;
+    for( int i = 0 ; i < n ; i++ )
+      oAxes[i] = oRotT*axes[i] ;
+    SATtest( oAxes, n, o, oMin, oMax ) ;
+    for( int i = 0 ; i < n ; i++ )
+    {
+      float off = axes[i].dot( oPos ) ;
+      oMin[i] += off, oMax[i] += off ;
+    }
+  }
+  
+  int count = n ;
+  n = 0 ;
+  for( int i = 0 ; i < count ; i++ )
+  {
+    float lowerLim, upperLim ;
+    if( !maxOverlaps( meMin[i], meMax[i], oMin[i], oMax[i], lowerLim, upperLim ) )
+      return 0 ; // NO OVERLAP IN AT LEAST 1 AXIS, SO NO INTERSECTION
+    
+    float overlap = upperLim - lowerLim ;
+    if( overlap < minOverlap ) {
+      // point it from me into o: me backs out along the opposite way, -axisOfMinOverlap
+      axisOfMinOverlap = upperLim == meMax[i] ? axes[i] : -axes[i] ;
+      minOverlap = overlap ;
+    }
+  }
+  return 1 ;
+}
+
 // GLobal function defining Matrix4f*Triangle.
 Triangle operator*( const Matrix4f& matrix, const Triangle& tri ) {
   return Triangle( matrix*tri.a, matrix*tri.b, matrix*tri.c ) ;
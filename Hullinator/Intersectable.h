@@ -15,6 +15,75 @@ void SATGetPtsWithExtremeDots( const Vector3f& axis, const vector<Vector3f>& ptS
 
 void SATGetPtsWithExtremeDots( const Vector3f& axis, const Vector3f *ptSet, int n, int& ptWithSmallestDot, int& ptWithBiggestDot ) ;
 
+// A pt set split into separate x, y and z arrays, for the SIMD SATtest.
+// The arrays are padded out to a multiple of SoAWidth with copies of the first pt,
+// which can't change a min or max, so the kernels never need a scalar tail.
+struct PointsSoA
+{
+  enum { SoAWidth = 8 } ;
+  vector<float> x, y, z ;
+  int n ; // # real pts (x.size() is that padded up)
+  
+  PointsSoA() : n(0) {}
+  PointsSoA( const vector<Vector3f>& pts ) { set( pts ) ; }
+  void set( const vector<Vector3f>& pts ) ;
+} ;
+
+// SATtest on SoA pts, by the fastest kernel this CPU runs (picked once, on the first call).
+// The SIMD kernels do the same mul/add sequence as Vector3f::dot, so they get the same answer.
+void SATtest( const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong ) ;
+
+// The kernels themselves, for benchmarking.  Only call the ones satKernelSupported says you can.
+enum SATKernel { SATKernelScalar, SATKernelSSE, SATKernelAVX2, SATKernelCount } ;
+extern const char* SATKernelName[ SATKernelCount ] ;
+bool satKernelSupported( SATKernel kernel ) ;
+SATKernel bestSATKernel() ;
+void SATtest( SATKernel kernel, const Vector3f& axis, const PointsSoA& pts, float& minAlong, float& maxAlong ) ;
+
+// SATtest onto numAxes axes at once: minAlong[i], maxAlong[i] are the pts' extent along axes[i].
+// The axes are taken a tile at a time, and each tile costs one pass over the pts (with the dots for
+// the whole tile in registers) instead of one pass per axis.  The tile is per kernel: 2 axes for SSE
+// and AVX2 (as many as fit the 16 vector registers), 4 for scalar.  Same answers as SATtest per axis.
+void SATtest( const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong ) ;
+void SATtest( SATKernel kernel, const Vector3f* axes, int numAxes, const PointsSoA& pts, float* minAlong, float* maxAlong ) ;
+
+// Runs SAT between 2 pt sets on axes you add() one at a time, projecting them BlockSize
+// at a time with the batched SATtest, and stopping at the first block with a separating axis.
+// Blocks are small because the separating axis is usually one of the first few: bigger ones
+// run faster when all the axes get tested, but throw away too much of the early out.
+// It also keeps the axis of least overlap, for penetration.
+struct SATBlockTest
+{
+  enum { BlockSize = 4 } ;
+  const PointsSoA &me, &o ;
+  Vector3f axes[ BlockSize ] ;
+  int n ;
+  
+  // Moving me by -axisOfMinOverlap*minOverlap is the least that clears o, along the axes tested so far
+  Vector3f axisOfMinOverlap ;
+  float minOverlap ;
+  
+  // When o's pts are in another space: pt p of o is at rot*p + oPos in mine (oRotT undoes rot).
+  bool oMoved ;
+  Matrix3f oRotT ;
+  Vector3f oPos ;
+  
+  SATBlockTest( const PointsSoA& iMe, const PointsSoA& iO ) : me( iMe ), o( iO ), n( 0 ), minOverlap( HUGE ), oMoved( 0 ) {}
+  
+  void moveO( const Matrix3f& rotT, const Vector3f& pos ) {
+    oMoved = 1, oRotT = rotT, oPos = pos ;
+  }
+  
+  // Returns 0 if it's found they're separated (axis may only be tested later, by flush).
+  bool add( const Vector3f& axis ) {
+    axes[ n++ ] = axis ;
+    return n < BlockSize || flush() ;
+  }
+  
+  // Tests the axes added since the last flush.  Returns 0 if one of them separates me and o.
+  bool flush() ;
+} ;
+
 
 // a collideable sphere
 struct Sphere
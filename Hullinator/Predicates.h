@@ -0,0 +1,182 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include "Vectorf.h"
+
+// Robust orientation test, after Shewchuk's "Adaptive Precision Floating-Point Arithmetic
+// and Fast Robust Geometric Predicates" (1997).
+//
+// orient3d( a, b, c, d ) is the sign of det[ a-d ; b-d ; c-d ]:
+//   > 0 if d is BELOW the plane of a,b,c (a,b,c appear counterclockwise seen from above),
+//   < 0 if d is above it (on the side a Plane( a, b, c ) normal points to),
+//   = 0 only if the 4 pts really are coplanar.
+// The sign is always right.  The det is first done in plain double and accepted if it is
+// bigger than a bound on its rounding error.  Only when it isn't (pts within a hair of
+// coplanar) is it redone exactly with expansion arithmetic.
+//
+// Don't build this with fast-math (-ffast-math, /fp:fast) or x87 extended precision:
+// the exact part depends on every double op rounding exactly once.
+struct ExactArith
+{
+  // x + y == a + b exactly, x is the rounded sum
+  static inline void twoSum( double a, double b, double& x, double& y )
+  {
+    x = a + b ;
+    double bVirt = x - a ;
+    double aVirt = x - bVirt ;
+    y = ( a - aVirt ) + ( b - bVirt ) ;
+  }
+
+  static inline void split( double a, double& hi, double& lo )
+  {
+    const double Splitter = 134217729.0 ; // 2^27 + 1
+    double c = Splitter * a ;
+    double big = c - a ;
+    hi = c - big ;
+    lo = a - hi ;
+  }
+
+  // x + y == a * b exactly, x is the rounded product
+  static inline void twoProduct( double a, double b, double& x, double& y )
+  {
+    x = a * b ;
+    double ahi, alo, bhi, blo ;
+    split( a, ahi, alo ) ;
+    split( b, bhi, blo ) ;
+    double err1 = x - ahi*bhi ;
+    double err2 = err1 - alo*bhi ;
+    double err3 = err2 - ahi*blo ;
+    y = alo*blo - err3 ;
+  }
+
+  // h = e + b.  e is an expansion (nonoverlapping, smallest magnitude first) of elen terms.
+  // Returns the length of h, zero terms are left out.  h can't be e.
+  static int growExpansion( int elen, const double* e, double b, double* h )
+  {
+    double q = b ;
+    int hlen = 0 ;
+    for( int i = 0 ; i < elen ; i++ )
+    {
+      double sum, err ;
+      twoSum( q, e[i], sum, err ) ;
+      q = sum ;
+      if( err != 0.0 )  h[hlen++] = err ;
+    }
+    if( q != 0.0 || !hlen )  h[hlen++] = q ;
+    return hlen ;
+  }
+
+  // h = e + f.  h needs room for elen+flen terms.
+  static int sumExpansions( int elen, const double* e, int flen, const double* f, double* h )
+  {
+    double scratch[2][64] ;
+    int hlen = elen ;
+    const double* cur = e ;
+    for( int i = 0 ; i < flen ; i++ )
+    {
+      double* dst = ( i == flen-1 ) ? h : scratch[i%2] ;
+      hlen = growExpansion( hlen, cur, f[i], dst ) ;
+      cur = dst ;
+    }
+    if( !flen )
+      for( int i = 0 ; i < elen ; i++ )  h[i] = e[i] ;
+    return hlen ;
+  }
+
+  // h = b * e.  h needs room for 2*elen terms.
+  static int scaleExpansion( int elen, const double* e, double b, double* h )
+  {
+    double q, err ;
+    int hlen = 0 ;
+    twoProduct( e[0], b, q, err ) ;
+    if( err != 0.0 )  h[hlen++] = err ;
+    for( int i = 1 ; i < elen ; i++ )
+    {
+      double prod, prodErr, sum ;
+      twoProduct( e[i], b, prod, prodErr ) ;
+      twoSum( q, prodErr, sum, err ) ;
+      if( err != 0.0 )  h[hlen++] = err ;
+      twoSum( prod, sum, q, err ) ;
+      if( err != 0.0 )  h[hlen++] = err ;
+    }
+    if( q != 0.0 || !hlen )  h[hlen++] = q ;
+    return hlen ;
+  }
+
+  // The sign of an expansion is the sign of its biggest (last) term
+  static inline double estimate( int elen, const double* e ) {
+    return e[elen-1] ;
+  }
+} ;
+
+// det[ a-d ; b-d ; c-d ] done exactly, from the raw coords.  As the coords are floats, each
+// product of 2 of them is exact in double, so the 2x2 minors are exact 2 term expansions.
+inline double orient3dExact( const Vector3f& a, const Vector3f& b, const Vector3f& c, const Vector3f& d )
+{
+  // m(u,v) = u.x*v.y - v.x*u.y
+  struct Minor
+  {
+    double e[2] ; int len ;
+    Minor( const Vector3f& u, const Vector3f& v ) {
+      double hi, lo ;
+      ExactArith::twoSum( (double)u.x*v.y, -( (double)v.x*u.y ), hi, lo ) ;
+      len = 0 ;
+      if( lo != 0.0 )  e[len++] = lo ;
+      if( hi != 0.0 || !len )  e[len++] = hi ;
+    }
+  } ;
+  Minor ab( a, b ), ac( a, c ), ad( a, d ), bc( b, c ), bd( b, d ), cd( c, d ) ;
+
+  // det3( p ; q ; r ) = p.z*m(q,r) - q.z*m(p,r) + r.z*m(p,q)
+  struct Det3
+  {
+    double e[12] ; int len ;
+    Det3( float pz, const Minor& qr, float qz, const Minor& pr, float rz, const Minor& pq ) {
+      double t1[4], t2[4], t3[4], t12[8] ;
+      int l1 = ExactArith::scaleExpansion( qr.len, qr.e, pz, t1 ) ;
+      int l2 = ExactArith::scaleExpansion( pr.len, pr.e, -qz, t2 ) ;
+      int l3 = ExactArith::scaleExpansion( pq.len, pq.e, rz, t3 ) ;
+      int l12 = ExactArith::sumExpansions( l1, t1, l2, t2, t12 ) ;
+      len = ExactArith::sumExpansions( l12, t12, l3, t3, e ) ;
+    }
+  } ;
+  Det3 abc( a.z, bc, b.z, ac, c.z, ab ), abd( a.z, bd, b.z, ad, d.z, ab ),
+       acd( a.z, cd, c.z, ad, d.z, ac ), bcd( b.z, cd, c.z, bd, d.z, bc ) ;
+
+  // Expanding the 4x4 [ a 1 ; b 1 ; c 1 ; d 1 ] down its column of 1's,
+  // det[ a-d ; b-d ; c-d ] = abc - abd + acd - bcd
+  for( int i = 0 ; i < abd.len ; i++ )  abd.e[i] = -abd.e[i] ;
+  for( int i = 0 ; i < bcd.len ; i++ )  bcd.e[i] = -bcd.e[i] ;
+  double s1[24], s2[24], det[48] ;
+  int l1 = ExactArith::sumExpansions( abc.len, abc.e, abd.len, abd.e, s1 ) ;
+  int l2 = ExactArith::sumExpansions( acd.len, acd.e, bcd.len, bcd.e, s2 ) ;
+  int len = ExactArith::sumExpansions( l1, s1, l2, s2, det ) ;
+  return ExactArith::estimate( len, det ) ;
+}
+
+inline double orient3d( const Vector3f& a, const Vector3f& b, const Vector3f& c, const Vector3f& d )
+{
+  double adx = (double)a.x - d.x, bdx = (double)b.x - d.x, cdx = (double)c.x - d.x ;
+  double ady = (double)a.y - d.y, bdy = (double)b.y - d.y, cdy = (double)c.y - d.y ;
+  double adz = (double)a.z - d.z, bdz = (double)b.z - d.z, cdz = (double)c.z - d.z ;
+
+  double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy ;
+  double cdxady = cdx*ady, adxcdy = adx*cdy ;
+  double adxbdy = adx*bdy, bdxady = bdx*ady ;
+
+  double det = adz*( bdxcdy - cdxbdy ) + bdz*( cdxady - adxcdy ) + cdz*( adxbdy - bdxady ) ;
+
+  // Shewchuk's bound on the error of the line above
+  const double Epsilon = 1.1102230246251565e-16 ; // 2^-53
+  const double ErrBound = ( 7.0 + 56.0*Epsilon )*Epsilon ;
+  double permanent = ( fabs( bdxcdy ) + fabs( cdxbdy ) )*fabs( adz ) +
+                     ( fabs( cdxady ) + fabs( adxcdy ) )*fabs( bdz ) +
+                     ( fabs( adxbdy ) + fabs( bdxady ) )*fabs( cdz ) ;
+  double errBound = ErrBound * permanent ;
+  if( det > errBound || -det > errBound )
+    return det ;
+
+  return orient3dExact( a, b, c, d ) ;
+}
+
+#endif
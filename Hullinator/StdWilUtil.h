@@ -265,7 +265,7 @@ inline bool maxOverlaps( float min1, float max1, float min2, float max2, float &
   if( isBetweenOrdered( min1, min2, max2 ) ) {
     // 1 || 3
     if( isBetweenOrdered( max2, min1, max1 ) )
-      lowerLim=min1,upperLim=max1 ; //case 1
+      lowerLim=min1,upperLim=max2 ; //case 1
     else { //3
       if( max1-min2 < max2-min1 )                   //   1111
         lowerLim=min2,upperLim=max1 ;               // 22222222222222
@@ -277,7 +277,7 @@ inline bool maxOverlaps( float min1, float max1, float min2, float max2, float &
   }
   else { //isBetweenOrdered( min2, min1, max1 ) must be true
     // 2 || 4 (non overlap case early returned)
-    if( isBetweenOrdered( max2, min1, max1 ) )
+    if( isBetweenOrdered( max1, min2, max2 ) )
       lowerLim=min2,upperLim=max1 ; // case 2
     else { // 4
       if( max2-min1 < max1-min2 ) // ls gap < rs gap    // 1111111111
@@ -0,0 +1,137 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+using namespace std ;
+
+// A fixed set of worker threads that run parallelFor jobs.
+// The thread that calls parallelFor works on the job too (as threadNo 0),
+// so a ThreadPool(1) has no workers and just runs everything inline.
+//
+// Each thread starts on its own contiguous run of the items, and when that runs
+// dry it steals items off the front of the other threads' runs.
+struct ThreadPool
+{
+  // A thread's run of items [next,end).  Padded out so threads don't share cache lines.
+  struct Run
+  {
+    atomic<int> next ;
+    int end ;
+    char pad[64 - sizeof(atomic<int>) - sizeof(int)] ;
+    
+    Run() : end(0) { next = 0 ; }
+    Run( const Run& o ) : end(o.end) { next = o.next.load() ; }
+  } ;
+
+  vector<thread> workers ;
+
+  mutex mtx ;
+  condition_variable wake, finished ;
+
+  // The job being run.  job( item, threadNo ) for item in [0,jobSize).
+  function<void (int,int)> job ;
+  int jobSize ;
+  vector<Run> runs ; // one per thread
+  int generation ; // bumped for each job so the workers know there's new work
+  int working ;    // # workers still on the current job
+  bool quitting ;
+
+  // 0 threads means one per hardware thread.
+  ThreadPool( int numThreads=0 ) : jobSize(0), generation(0), working(0), quitting(0)
+  {
+    if( numThreads <= 0 )  numThreads = hardwareThreads() ;
+    runs.resize( numThreads ) ;
+    for( int i = 1 ; i < numThreads ; i++ )
+      workers.push_back( thread( &ThreadPool::workerLoop, this, i ) ) ;
+  }
+
+  ~ThreadPool()
+  {
+    {
+      lock_guard<mutex> lock( mtx ) ;
+      quitting = 1 ;
+    }
+    wake.notify_all() ;
+    for( int i = 0 ; i < workers.size() ; i++ )
+      workers[i].join() ;
+  }
+
+  static int hardwareThreads() {
+    int n = (int)thread::hardware_concurrency() ;
+    return n > 0 ? n : 1 ;
+  }
+
+  // # threads that run jobs, counting the caller's
+  int size() const { return (int)workers.size() + 1 ; }
+
+  // Runs fn( item, threadNo ) for every item in [0,n), and returns when they are all done.
+  // threadNo is in [0,size()), so you can keep per-thread scratch in an array of size().
+  void parallelFor( int n, const function<void (int,int)>& fn )
+  {
+    if( n <= 0 )  return ;
+    if( workers.empty() || n == 1 ) {
+      for( int i = 0 ; i < n ; i++ )  fn( i, 0 ) ;
+      return ;
+    }
+
+    {
+      lock_guard<mutex> lock( mtx ) ;
+      job = fn ;
+      jobSize = n ;
+      // deal the items out evenly
+      for( int t = 0 ; t < runs.size() ; t++ )
+      {
+        runs[t].next = (int)( (long long)n*t / runs.size() ) ;
+        runs[t].end = (int)( (long long)n*(t+1) / runs.size() ) ;
+      }
+      working = (int)workers.size() ;
+      generation++ ;
+    }
+    wake.notify_all() ;
+
+    runItems( 0 ) ;
+
+    unique_lock<mutex> lock( mtx ) ;
+    while( working )  finished.wait( lock ) ;
+    job = function<void (int,int)>() ;
+  }
+
+private:
+  // Do my own run, then steal from the others' until every run is empty.
+  void runItems( int threadNo )
+  {
+    for( int k = 0 ; k < runs.size() ; k++ )
+    {
+      Run& run = runs[ (threadNo + k) % runs.size() ] ;
+      int i ;
+      while( (i = run.next++) < run.end )
+        job( i, threadNo ) ;
+    }
+  }
+
+  void workerLoop( int threadNo )
+  {
+    int seenGeneration = 0 ;
+    for( ;; )
+    {
+      {
+        unique_lock<mutex> lock( mtx ) ;
+        while( !quitting && generation == seenGeneration )  wake.wait( lock ) ;
+        if( quitting )  return ;
+        seenGeneration = generation ;
+      }
+
+      runItems( threadNo ) ;
+
+      lock_guard<mutex> lock( mtx ) ;
+      if( !--working )  finished.notify_one() ;
+    }
+  }
+} ;
+
+#endif
@@ -1978,7 +1978,140 @@ union Matrix4f
  
 } ;
 
+// A unit quaternion: a rotation in 4 floats where a Matrix3f takes 9.  q*r rotates by r, then by q.
+// A product of many of them drifts off unit length, which normalize() puts right: it can't pick
+// up shear or scale the way a Matrix3f multiplied into itself over and over does.
+struct Quaternion
+{
+  float x,y,z,w ;
+  
+  Quaternion():x(0.f),y(0.f),z(0.f),w(1.f){} // IDENTITY
+  Quaternion( float ix, float iy, float iz, float iw ):x(ix),y(iy),z(iz),w(iw){}
+  
+  // The rotation in rot, which must be orthonormal.  Picks the biggest of w,x,y,z to divide by.
+  Quaternion( const Matrix3f& rot )
+  {
+    // COLUMN MAJOR: row r col c is m{c}{r}
+    float trace = rot.m00 + rot.m11 + rot.m22 ;
+    if( trace > 0 ) {
+      float s = 2.f*sqrtf( 1.f + trace ) ; // 4w
+      w = s/4 ;  x = ( rot.m12 - rot.m21 )/s ;  y = ( rot.m20 - rot.m02 )/s ;  z = ( rot.m01 - rot.m10 )/s ;
+    }
+    else if( rot.m00 > rot.m11 && rot.m00 > rot.m22 ) {
+      float s = 2.f*sqrtf( 1.f + rot.m00 - rot.m11 - rot.m22 ) ; // 4x
+      w = ( rot.m12 - rot.m21 )/s ;  x = s/4 ;  y = ( rot.m10 + rot.m01 )/s ;  z = ( rot.m20 + rot.m02 )/s ;
+    }
+    else if( rot.m11 > rot.m22 ) {
+      float s = 2.f*sqrtf( 1.f + rot.m11 - rot.m00 - rot.m22 ) ; // 4y
+      w = ( rot.m20 - rot.m02 )/s ;  x = ( rot.m10 + rot.m01 )/s ;  y = s/4 ;  z = ( rot.m21 + rot.m12 )/s ;
+    }
+    else {
+      float s = 2.f*sqrtf( 1.f + rot.m22 - rot.m00 - rot.m11 ) ; // 4z
+      w = ( rot.m01 - rot.m10 )/s ;  x = ( rot.m20 + rot.m02 )/s ;  y = ( rot.m21 + rot.m12 )/s ;  z = s/4 ;
+    }
+  }
+  
+  // u must be unit length.  Turns the same way as Matrix3f::rotationX/Y/Z
+  // (Matrix3f::rotation( u, radians ) turns the other way: it's this by -radians).
+  inline static Quaternion rotation( const Vector3f& u, float radians )
+  {
+    float s = sinf( radians/2 ) ;
+    return Quaternion( u.x*s, u.y*s, u.z*s, cosf( radians/2 ) ) ;
+  }
+  
+  inline Vector3f xyz() const { return Vector3f( x, y, z ) ; }
+  inline float len() const { return sqrtf( x*x + y*y + z*z + w*w ) ; }
+  
+  inline Quaternion& normalize(){
+    float length = len() ;
+    if( !length ) {
+      error( "Quaternion::normalize() attempt to divide by 0" ) ;
+      return *this ;
+    }
+    x/=length ;  y/=length ;  z/=length ;  w/=length ;
+    return *this ;
+  }
+  
+  // The inverse, for a unit quaternion
+  inline Quaternion conjugate() const { return Quaternion( -x, -y, -z, w ) ; }
+  
+  // o, then me. 16 mul, 12 add (a Matrix3f product is 27 and 18)
+  inline Quaternion operator*( const Quaternion& o ) const
+  {
+    return Quaternion(
+      w*o.x + x*o.w + y*o.z - z*o.y,
+      w*o.y - x*o.z + y*o.w + z*o.x,
+      w*o.z + x*o.y - y*o.x + z*o.w,
+      w*o.w - x*o.x - y*o.y - z*o.z
+    ) ;
+  }
+  
+  // Rotates v.  18 mul, 12 add: twice the 3x3's 9 and 6, so to rotate a lot
+  // of vectors, expand to toMatrix3f() once and use that.
+  inline Vector3f operator*( const Vector3f& v ) const
+  {
+    Vector3f q = xyz() ;
+    Vector3f t = q.cross( v ) * 2.f ;
+    return v + t*w + q.cross( t ) ;
+  }
+  
+  Matrix3f toMatrix3f() const
+  {
+    float xx=x*x, yy=y*y, zz=z*z, xy=x*y, xz=x*z, yz=y*z, wx=w*x, wy=w*y, wz=w*z ;
+    
+    // COLUMN MAJOR: each line is a column
+    return Matrix3f(
+      1.f - 2.f*(yy+zz),  2.f*(xy+wz),        2.f*(xz-wy),
+      2.f*(xy-wz),        1.f - 2.f*(xx+zz),  2.f*(yz+wx),
+      2.f*(xz+wy),        2.f*(yz-wx),        1.f - 2.f*(xx+yy)
+    ) ;
+  }
+} ;
 
+// A rigid move: pt p goes to rot*p + pos.  7 floats where a Matrix4f takes 16,
+// 2 compose in 61 flops where 2 Matrix4f's take 112, and it can't shear or scale.
+struct RigidTransform
+{
+  Quaternion rot ;
+  Vector3f pos ;
+  
+  RigidTransform() {} // IDENTITY
+  RigidTransform( const Quaternion& iRot, const Vector3f& iPos ) : rot( iRot ), pos( iPos ) {}
+  // The rotation and translation of m, which must not scale or shear
+  explicit RigidTransform( const Matrix4f& m ) : rot( m.getRotation() ), pos( m.getTranslation() ) {}
+  
+  inline Vector3f operator*( const Vector3f& p ) const { return rot*p + pos ; }
+  // Rotates only, for normals and directions
+  inline Vector3f dir( const Vector3f& d ) const { return rot*d ; }
+  
+  // o, then me
+  inline RigidTransform operator*( const RigidTransform& o ) const {
+    return RigidTransform( rot*o.rot, rot*o.pos + pos ) ;
+  }
+  inline RigidTransform inverse() const {
+    Quaternion back = rot.conjugate() ;
+    return RigidTransform( back, -( back*pos ) ) ;
+  }
+  
+  Matrix4f toMatrix4f() const { return Matrix4f( rot.toMatrix3f(), pos ) ; }
+  
+  // out[i] = *this * in[i], for n pts.  The rotation is expanded to a 3x3 once for the
+  // whole batch, so each pt costs 9 mul and 9 add.  in and out can be the same array.
+  void apply( const Vector3f* in, Vector3f* out, int n ) const
+  {
+    Matrix3f m = rot.toMatrix3f() ;
+    for( int i = 0 ; i < n ; i++ )
+      out[i] = m*in[i] + pos ;
+  }
+  
+  // out[i] = dir( in[i] ), for n directions
+  void applyDir( const Vector3f* in, Vector3f* out, int n ) const
+  {
+    Matrix3f m = rot.toMatrix3f() ;
+    for( int i = 0 ; i < n ; i++ )
+      out[i] = m*in[i] ;
+  }
+} ;
 
 
 
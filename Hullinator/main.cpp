@@ -115,7 +115,368 @@ void shiftPointClouds() {
   for( int i = 0 ; i < pointCloud2.size() ; i++ ) {
     pointCloud2[i] += Vector3f::random(-.2,.2) ;
   }
-  regenHulls() ;
+  // The pts only jiggled, so the hulls start from where they were
+  hull1.rebuildWarm( pointCloud1 ) ;
+  hull2.rebuildWarm( pointCloud2 ) ;
+}
+
+// Streams a few more pts into each cloud, and grows the hulls to take
+// them in instead of rebuilding them.
+void growPointClouds() {
+  vector<Vector3f> more1, more2 ;
+  for( int i = 0 ; i < 5 ; i++ )
+  {
+    more1.push_back( pointCloud1[ randInt( 0, (int)pointCloud1.size() ) ] + Vector3f::random(-4,4) ) ;
+    more2.push_back( pointCloud2[ randInt( 0, (int)pointCloud2.size() ) ] + Vector3f::random(-4,4) ) ;
+  }
+  pointCloud1.insert( pointCloud1.end(), more1.begin(), more1.end() ) ;
+  pointCloud2.insert( pointCloud2.end(), more2.begin(), more2.end() ) ;
+  hull1.insertPoints( more1 ) ;
+  hull2.insertPoints( more2 ) ;
+}
+
+// Throughput of buildHulls (hulls/second) vs thread count, on a batch of
+// small clouds the size of a typical submesh.
+void benchmarkBatchHulls()
+{
+  const int numClouds = 2000, ptsPerCloud = 200 ;
+  vector< vector<Vector3f> > clouds( numClouds ) ;
+  vector<PointCloudView> views ;
+  for( int i = 0 ; i < numClouds ; i++ )
+  {
+    for( int j = 0 ; j < ptsPerCloud ; j++ )
+      clouds[i].push_back( Vector3f::random(-10,10) ) ;
+    views.push_back( PointCloudView( clouds[i] ) ) ;
+  }
+  
+  vector<Hull> hulls ;
+  for( int threads = 1 ; threads <= ThreadPool::hardwareThreads() ; threads *= 2 )
+  {
+    ThreadPool pool( threads ) ;
+    Timer timer ;
+    buildHulls( &views[0], numClouds, hulls, pool ) ;
+    double secs = timer.getTime() ;
+    info( "buildHulls: %d threads, %d hulls of %d pts in %.3fs, %.0f hulls/s", threads, numClouds, ptsPerCloud, secs, numClouds/secs ) ;
+    msg( makeString( "bench%d", threads ), makeString( "%d threads: %.0f hulls/s", threads, numClouds/secs ) ) ;
+  }
+}
+
+// Boolean hull-hull queries/second, SAT (intersectsHull) vs GJK (intersectsHullGJK),
+// on pairs of clouds made the same way newPointClouds does.  Then penetration queries
+// on the pairs that hit, SAT vs EPA (intersectsHullEPA).  Then GJK vs a HullPairCache
+// over frames of the second hulls drifting a little each frame, and moving the hulls eagerly
+// vs in local space.
+void benchmarkHullQueries()
+{
+  const int numPairs = 200, queriesPerPair = 500 ;
+  vector<Hull> hulls1( numPairs ), hulls2( numPairs ) ;
+  for( int i = 0 ; i < numPairs ; i++ )
+  {
+    vector<Vector3f> cloud1, cloud2 ;
+    Vector3f c1=Vector3f::random( 0, 15 ), c2=Vector3f::random(-15,0) ;
+    for( int j = 0 ; j < pointsPerCloud ; j++ )
+    {
+      cloud1.push_back( c1 + Vector3f::random(-10,10) ) ;
+      cloud2.push_back( c2 + Vector3f::random(-10,10) ) ;
+    }
+    hulls1[i] = Hull( cloud1 ), hulls2[i] = Hull( cloud2 ) ;
+  }
+  
+  int satHits = 0, gjkHits = 0, disagree = 0 ;
+  Timer timer ;
+  for( int i = 0 ; i < numPairs ; i++ )
+    for( int q = 0 ; q < queriesPerPair ; q++ )
+      satHits += hulls1[i].intersectsHull( hulls2[i] ) ;
+  double satSecs = timer.getTime() ;
+  
+  timer.reset() ;
+  for( int i = 0 ; i < numPairs ; i++ )
+    for( int q = 0 ; q < queriesPerPair ; q++ )
+      gjkHits += hulls1[i].intersectsHullGJK( hulls2[i] ) ;
+  double gjkSecs = timer.getTime() ;
+  
+  for( int i = 0 ; i < numPairs ; i++ )
+    disagree += hulls1[i].intersectsHull( hulls2[i] ) != hulls1[i].intersectsHullGJK( hulls2[i] ) ;
+  
+  int queries = numPairs*queriesPerPair ;
+  info( "hull-hull, %d pts per hull, %d pairs (%d hit): SAT %.0f queries/s, GJK %.0f queries/s, %d disagree",
+    pointsPerCloud, numPairs, satHits/queriesPerPair, queries/satSecs, queries/gjkSecs, disagree ) ;
+  msg( "benchq", makeString( "%d pts: SAT %.0f/s  GJK %.0f/s", pointsPerCloud, queries/satSecs, queries/gjkSecs ) ) ;
+  
+  const int frames = 200 ;
+  vector<Vector3f> drift( numPairs ) ;
+  for( int i = 0 ; i < numPairs ; i++ )
+    drift[i] = Vector3f::random(-.1,.1) ;
+  HullPairCache cache ;
+  double cachedSecs = 0 ;
+  gjkSecs = 0 ;
+  for( int f = 0 ; f < frames ; f++ )
+  {
+    for( int i = 0 ; i < numPairs ; i++ )
+      hulls2[i].translateTransformed( drift[i] ) ;
+    
+    timer.reset() ;
+    for( int i = 0 ; i < numPairs ; i++ )
+      gjkHits += hulls1[i].intersectsHullGJK( hulls2[i] ) ;
+    gjkSecs += timer.getTime() ;
+    
+    timer.reset() ;
+    for( int i = 0 ; i < numPairs ; i++ )
+      gjkHits += cache.intersects( hulls1[i], hulls2[i] ) ;
+    cachedSecs += timer.getTime() ;
+  }
+  queries = numPairs*frames ;
+  info( "hull-hull over %d frames: GJK %.0f queries/s, cached %.0f queries/s, cache answered %lld of %lld (%lld axis misses)",
+    frames, queries/gjkSecs, queries/cachedSecs, cache.axisHits, cache.queries, cache.axisMisses ) ;
+  msg( "benchc", makeString( "frames: GJK %.0f/s  cached %.0f/s (%.0f%% hits)", queries/gjkSecs, queries/cachedSecs, 100*cache.hitRate() ) ) ;
+  
+  // The same kind of frames (each hull spinning about its middle, and drifting), with every hull
+  // moved eagerly vs kept in local space, where a move only changes the pose, vs with lazy
+  // transforms, where a move only changes transformedMatrix until a query needs the arrays.
+  vector<Hull> eager = hulls2, local = hulls2, lazy = hulls2 ;
+  for( int i = 0 ; i < numPairs ; i++ )
+  {
+    eager[i].transform( Matrix4f() ) ;
+    local[i].setLocalSpace( 1 ) ;
+    lazy[i].transform( Matrix4f() ) ;
+    lazy[i].setLazyTransforms( 1 ) ;
+  }
+  Matrix3f spin = Matrix3f::rotationY( 0.01f ) ;
+  double eagerMoveSecs = 0, localMoveSecs = 0, eagerQuerySecs = 0, localQuerySecs = 0, lazySecs = 0 ;
+  disagree = 0 ;
+  for( int f = 0 ; f < frames ; f++ )
+  {
+    timer.reset() ;
+    for( int i = 0 ; i < numPairs ; i++ ) {
+      eager[i].untranslateRotateTranslate( hulls2[i].aabb.mid(), spin ) ;
+      eager[i].translateTransformed( drift[i] ) ;
+    }
+    eagerMoveSecs += timer.getTime() ;
+    
+    timer.reset() ;
+    for( int i = 0 ; i < numPairs ; i++ ) {
+      local[i].untranslateRotateTranslate( hulls2[i].aabb.mid(), spin ) ;
+      local[i].translateTransformed( drift[i] ) ;
+    }
+    localMoveSecs += timer.getTime() ;
+    
+    timer.reset() ;
+    for( int i = 0 ; i < numPairs ; i++ ) {
+      lazy[i].untranslateRotateTranslate( hulls2[i].aabb.mid(), spin ) ;
+      lazy[i].translateTransformed( drift[i] ) ;
+    }
+    for( int i = f%10 ; i < numPairs ; i += 10 )
+      hulls1[i].intersectsHull( lazy[i] ) ;
+    lazySecs += timer.getTime() ;
+    
+    // only every 10th pair gets asked about each frame
+    int eagerHits = 0, localHits = 0 ;
+    timer.reset() ;
+    for( int i = f%10 ; i < numPairs ; i += 10 )
+      eagerHits += hulls1[i].intersectsHull( eager[i] ) ;
+    eagerQuerySecs += timer.getTime() ;
+    
+    timer.reset() ;
+    for( int i = f%10 ; i < numPairs ; i += 10 )
+      localHits += hulls1[i].intersectsHull( local[i] ) ;
+    localQuerySecs += timer.getTime() ;
+    disagree += abs( eagerHits - localHits ) ;
+  }
+  info( "hull moves over %d frames, querying 1 pair in 10: eager %.3fms/frame (%.3fms moving), local space %.3fms/frame (%.3fms moving), %d disagree",
+    frames, 1e3*( eagerMoveSecs + eagerQuerySecs )/frames, 1e3*eagerMoveSecs/frames,
+    1e3*( localMoveSecs + localQuerySecs )/frames, 1e3*localMoveSecs/frames, disagree ) ;
+  long long avoided = 0, materialized = 0 ;
+  for( int i = 0 ; i < numPairs ; i++ )
+    avoided += lazy[i].avoidedMaterializations(), materialized += lazy[i].materializations ;
+  info( "lazy transforms: %.3fms/frame, %lld arrays transformed, %lld transforms avoided",
+    1e3*lazySecs/frames, materialized, avoided ) ;
+  msg( "benchl", makeString( "moves: eager %.3fms/frame  local space %.3fms/frame  lazy %.3fms/frame",
+    1e3*( eagerMoveSecs + eagerQuerySecs )/frames, 1e3*( localMoveSecs + localQuerySecs )/frames, 1e3*lazySecs/frames ) ) ;
+  
+  vector<int> hitPairs ;
+  for( int i = 0 ; i < numPairs ; i++ )
+    if( hulls1[i].intersectsHull( hulls2[i] ) )
+      hitPairs.push_back( i ) ;
+  if( hitPairs.empty() )  return ;
+  
+  Vector3f pene, contact1, contact2 ;
+  timer.reset() ;
+  for( int i = 0 ; i < hitPairs.size() ; i++ )
+    for( int q = 0 ; q < queriesPerPair ; q++ )
+      hulls1[ hitPairs[i] ].intersectsHull( hulls2[ hitPairs[i] ], pene, contact1, contact2 ) ;
+  satSecs = timer.getTime() ;
+  
+  timer.reset() ;
+  for( int i = 0 ; i < hitPairs.size() ; i++ )
+    for( int q = 0 ; q < queriesPerPair ; q++ )
+      hulls1[ hitPairs[i] ].intersectsHullEPA( hulls2[ hitPairs[i] ], pene, contact1, contact2 ) ;
+  double epaSecs = timer.getTime() ;
+  
+  queries = (int)hitPairs.size()*queriesPerPair ;
+  info( "hull-hull penetration, %d pairs: SAT %.0f queries/s, EPA %.0f queries/s", (int)hitPairs.size(), queries/satSecs, queries/epaSecs ) ;
+  msg( "benchp", makeString( "penetration: SAT %.0f/s  EPA %.0f/s", queries/satSecs, queries/epaSecs ) ) ;
+}
+
+// The answers hull a gives about hull b and a few random shapes, as numbers (1/0 for the
+// bools), so 2 ways of moving the same hulls can be checked against each other.
+// Penetrations go in by depth: 2 contacts equally deep are both right.
+vector<float> hullQueryAnswers( const Hull& a, const Hull& b )
+{
+  vector<float> answers ;
+  Vector3f pene, contact1, contact2 ;
+  answers.push_back( a.intersectsHull( b ) ) ;
+  answers.push_back( a.intersectsHullGJK( b ) ) ;
+  if( a.intersectsHull( b, pene, contact1, contact2 ) )
+    answers.push_back( pene.len() ) ;
+  
+  for( int q = 0 ; q < 10 ; q++ )
+  {
+    Vector3f pt = Vector3f::random(-15,15), closest ;
+    answers.push_back( a.inside( pt ) ) ;
+    answers.push_back( a.distanceToClosestPointOnHull( pt, closest ) ) ;
+    
+    float t1, t2 ;
+    if( a.intersectsRay( Ray( pt, Vector3f::random(-15,15) ), t1, t2 ) )
+      answers.push_back( t1 ), answers.push_back( t2 ) ;
+    else
+      answers.push_back( -1 ) ;
+    
+    PrecomputedTriangle tri( pt, Vector3f::random(-15,15), Vector3f::random(-15,15) ) ;
+    answers.push_back( a.intersectsTri( tri ) ) ;
+    if( a.intersectsTri( tri, pene ) )
+      answers.push_back( pene.len() ) ;
+    answers.push_back( a.intersectsSphere( Sphere( pt, randFloat( 1, 5 ) ) ) ) ;
+    answers.push_back( a.intersectsAABB( AABB( pt - Vector3f( 2 ), pt + Vector3f( 2 ) ) ) ) ;
+  }
+  return answers ;
+}
+
+// Cross-checks the ways of moving a hull: the same random mix of every transform* call goes to
+// a hull moved eagerly, a copy of it in local space and a copy with lazy transforms, and then
+// every query is asked of each.  They should agree (up to float error).
+void verifyHullMoves()
+{
+  enum { Eager, Local, Lazy, NumWays } ;
+  static const char* WayName[] = { "eager", "local space", "lazy" } ;
+  const int numPairs = 100, frames = 20 ;
+  int checked = 0, disagree[ NumWays ] = { 0 } ;
+  for( int i = 0 ; i < numPairs ; i++ )
+  {
+    vector<Vector3f> cloud1, cloud2 ;
+    for( int j = 0 ; j < pointsPerCloud ; j++ )
+    {
+      cloud1.push_back( Vector3f::random(-10,10) ) ;
+      cloud2.push_back( Vector3f::random(-10,10) ) ;
+    }
+    Hull hulls[ NumWays ][ 2 ] ;
+    for( int w = 0 ; w < NumWays ; w++ )
+      hulls[w][0] = Hull( cloud1 ), hulls[w][1] = Hull( cloud2 ) ;
+    for( int h = 0 ; h < 2 ; h++ ) {
+      hulls[Local][h].setLocalSpace( 1 ) ;
+      hulls[Lazy][h].setLazyTransforms( 1 ) ;
+    }
+    
+    for( int f = 0 ; f < frames ; f++ )
+    {
+      // Switching local space off and on again mustn't move anything
+      if( f == frames/2 )
+        for( int h = 0 ; h < 2 ; h++ )
+          hulls[Local][h].setLocalSpace( 0 ), hulls[Local][h].setLocalSpace( 1 ) ;
+      
+      int h = randInt( 0, 2 ), kind = randInt( 0, 5 ) ;
+      Matrix3f rot = Matrix3f::rotationYawPitchRoll( randFloat(-.5,.5), randFloat(-.5,.5), randFloat(-.5,.5) ) ;
+      Vector3f t = Vector3f::random(-3,3) ;
+      for( int w = 0 ; w < NumWays ; w++ )
+      {
+        Hull& hull = hulls[w][h] ;
+        switch( kind )
+        {
+          case 0:  hull.transform( Matrix4f( rot, t ) ) ;  break ;
+          case 1:  hull.transformTransformed( Matrix4f( rot, t ) ) ;  break ;
+          case 2:  hull.transformTransformed( rot ) ;  break ;
+          case 3:  hull.translateTransformed( t ) ;  break ;
+          default:  hull.untranslateRotateTranslate( t, rot ) ;  break ;
+        }
+      }
+      
+      // The same random shapes for every way
+      int seed = randInt( 0, 1<<30 ) ;
+      randSeed( seed ) ;
+      vector<float> expected = hullQueryAnswers( hulls[Eager][0], hulls[Eager][1] ) ;
+      for( int w = 1 ; w < NumWays ; w++ )
+      {
+        randSeed( seed ) ;
+        vector<float> answers = hullQueryAnswers( hulls[w][0], hulls[w][1] ) ;
+        bool same = answers.size() == expected.size() ;
+        for( int q = 0 ; q < answers.size() && same ; q++ )
+          same = fabsf( answers[q] - expected[q] ) <= 1e-3f*( 1 + fabsf( expected[q] ) ) ;
+        disagree[w] += !same ;
+      }
+      checked++ ;
+    }
+  }
+  
+  string line ;
+  int total = 0 ;
+  for( int w = 1 ; w < NumWays ; w++ ) {
+    line += makeString( "%s%s %d", w > 1 ? ", " : "", WayName[w], disagree[w] ) ;
+    total += disagree[w] ;
+  }
+  info( "hull moves vs eager, %d frames of queries, disagreeing: %s", checked, line.c_str() ) ;
+  msg( "verify", makeString( "moves vs eager, frames disagreeing: %s (of %d)", line.c_str(), checked ), total ? Red : Gray ) ;
+}
+
+// Points/ns of each SATtest kernel (the AoS one, and each SoA one this CPU runs),
+// projecting random pt sets of a few sizes onto random axes.
+void benchmarkSATKernels()
+{
+  const int sizes[] = { 64, 1024, 16384 } ;
+  const int numAxes = 64 ;
+  vector<Vector3f> axes ;
+  for( int i = 0 ; i < numAxes ; i++ )
+    axes.push_back( Vector3f::randomSpherical( 1 ) ) ;
+  
+  for( int s = 0 ; s < 3 ; s++ )
+  {
+    vector<Vector3f> pts ;
+    for( int i = 0 ; i < sizes[s] ; i++ )
+      pts.push_back( Vector3f::random(-10,10) ) ;
+    PointsSoA soa( pts ) ;
+    int reps = max( 1, 4000000 / ( sizes[s]*numAxes ) ) ;
+    double ptsProjected = (double)reps*numAxes*sizes[s] ;
+    float mn, mx, sum = 0 ; // sum so the loops can't be thrown away
+    
+    Timer timer ;
+    for( int r = 0 ; r < reps ; r++ )
+      for( int a = 0 ; a < numAxes ; a++ ) {
+        SATtest( axes[a], pts, mn, mx ) ;
+        sum += mx - mn ;
+      }
+    string line = makeString( "%5d pts: AoS %.2f", sizes[s], ptsProjected / ( timer.getTime()*1e9 ) ) ;
+    
+    for( int k = 0 ; k < SATKernelCount ; k++ )
+    {
+      if( !satKernelSupported( (SATKernel)k ) )  continue ;
+      timer.reset() ;
+      for( int r = 0 ; r < reps ; r++ )
+        for( int a = 0 ; a < numAxes ; a++ ) {
+          SATtest( (SATKernel)k, axes[a], soa, mn, mx ) ;
+          sum += mx - mn ;
+        }
+      line += makeString( ", %s %.2f", SATKernelName[k], ptsProjected / ( timer.getTime()*1e9 ) ) ;
+      
+      // the same axes all in one batched call
+      float mins[ numAxes ], maxs[ numAxes ] ;
+      timer.reset() ;
+      for( int r = 0 ; r < reps ; r++ ) {
+        SATtest( (SATKernel)k, &axes[0], numAxes, soa, mins, maxs ) ;
+        sum += maxs[ r % numAxes ] - mins[ r % numAxes ] ;
+      }
+      line += makeString( " (batched %.2f)", ptsProjected / ( timer.getTime()*1e9 ) ) ;
+    }
+    info( "SATtest pts/ns, %s (checksum %f)", line.c_str(), sum ) ;
+    msg( makeString( "benchk%d", s ), line + " pts/ns" ) ;
+  }
 }
 
 void init() // Called before main loop to set up the program
@@ -137,7 +498,7 @@ void help()
   {
     case Mode::HullHull:
       msg( "instr1", "(m) makes new point clouds.  +/- to change # pts per cloud." ) ;
-      msg( "instr2", "holding (r) jiggles the clouds. (e) shows the original points that made up the hull." ) ;
+      msg( "instr2", "holding (r) jiggles the clouds. (e) shows the original points that made up the hull. (g) grows the clouds. (b) benchmarks. (q) benchmarks SAT vs GJK/EPA. (k) benchmarks SAT kernels. (v) verifies local space and lazy transforms against eager moves." ) ;
       break;
     case Mode::HullTri:
       msg( "instr1", "left/right arrows to spin tri. Also (m), (+/-)" ) ;
@@ -786,6 +1147,10 @@ void keyboard( unsigned char key, int x, int y )
     goto NEWPOINTCLOUDS ; // goto programming revival.
     break; 
   
+  case 'b':
+    benchmarkBatchHulls() ;
+    break ;
+  
   case 'c':
   CLEAR:
     debugPointsPerm.clear() ;
@@ -799,10 +1164,19 @@ void keyboard( unsigned char key, int x, int y )
       msg( "lw", makeString( "(p/P)ointsize (%.0f)", ptSize ) ) ;
     break ;
     
+  case 'g':
+    if( pointCloud1.size() && pointCloud2.size() )
+      growPointClouds() ;
+    break ;
+  
   case 'h':
     help() ;
     break ;
   
+  case 'k':
+    benchmarkSATKernels() ;
+    break ;
+  
   case 'l':
     lineWidth++;
     msg( "lw", makeString( "(l/L)inewidth (%.0f)", lineWidth ) );
@@ -821,6 +1195,14 @@ void keyboard( unsigned char key, int x, int y )
     goto CLEAR ; // goto programming revival.
     break ;
   
+  case 'q':
+    benchmarkHullQueries() ;
+    break ;
+  
+  case 'v':
+    verifyHullMoves() ;
+    break ;
+  
   case 'p':
     ptSize++;
     msg( "lw", makeString( "(p/P)ointsize (%.0f)", ptSize ) ) ;